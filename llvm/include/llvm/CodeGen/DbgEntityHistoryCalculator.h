@@ -92,6 +92,9 @@ public:
   void clear() { VarEntries.clear(); }
   EntriesMap::const_iterator begin() const { return VarEntries.begin(); }
   EntriesMap::const_iterator end() const { return VarEntries.end(); }
+  EntriesMap::const_iterator find(InlinedEntity Var) const {
+    return VarEntries.find(Var);
+  }
 
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
   LLVM_DUMP_METHOD void dump() const;
@@ -17,6 +17,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace llvm {
 
@@ -83,6 +84,26 @@ public:
   };
   using AttributeSpecVector = SmallVector<AttributeSpec, 8>;
 
+  /// One step of a skip program: advance over a run of attribute values of
+  /// fixed size, then over one value of variable size.
+  struct SkipStep {
+    enum StepKind : uint8_t {
+      End,          ///< No more attribute values.
+      ULEB128,      ///< A ULEB128 value.
+      SLEB128,      ///< A SLEB128 value.
+      BlockULEB128, ///< A ULEB128 length followed by that many bytes.
+      Block1,       ///< A 1 byte length followed by that many bytes.
+      Block2,       ///< A 2 byte length followed by that many bytes.
+      Block4,       ///< A 4 byte length followed by that many bytes.
+      CString,      ///< A null terminated string.
+      Other         ///< A value skipped by DWARFFormValue::skipValue().
+    };
+
+    uint32_t FixedBytes;
+    StepKind Kind;
+    dwarf::Form Form;
+  };
+
   DWARFAbbreviationDeclaration();
 
   uint32_t getCode() const { return Code; }
@@ -130,7 +151,7 @@ public:
   /// \param Attr DWARF attribute to search for.
   /// \param U the DWARFUnit the contains the DIE.
   /// \returns Optional DWARF form value if the attribute was extracted.
-  Optional<DWARFFormValue> getAttributeValue(const uint32_t DIEOffset,
+  Optional<DWARFFormValue> getAttributeValue(const uint64_t DIEOffset,
                                              const dwarf::Attribute Attr,
                                              const DWARFUnit &U) const;
 
@@ -142,6 +163,13 @@ public:
   // DWARF parsing to be faster as many DWARF DIEs have a fixed byte size.
   Optional<size_t> getFixedAttributesByteSize(const DWARFUnit &U) const;
 
+  /// Append to \p Program the steps that skip all attribute data of a DIE
+  /// with this abbreviation, in a unit with the given form parameters. Runs
+  /// of fixed size values are coalesced into a single step, and the program
+  /// is terminated by a step of kind SkipStep::End.
+  void appendSkipProgram(dwarf::FormParams Params,
+                         std::vector<SkipStep> &Program) const;
+
 private:
   void clear();
 
@@ -47,10 +47,35 @@ public:
     return Decls.end();
   }
 
+  /// Return the position of \p Decl, which belongs to this set.
+  size_t getIndex(const DWARFAbbreviationDeclaration *Decl) const {
+    return Decl - Decls.data();
+  }
+
 private:
   void clear();
 };
 
+/// The skip programs of all the abbreviations of a set, compiled for the
+/// form parameters of one unit.
+class DWARFAbbreviationSkipTable {
+  using SkipStep = DWARFAbbreviationDeclaration::SkipStep;
+
+  const DWARFAbbreviationDeclarationSet &Set;
+  std::vector<SkipStep> Steps;
+  /// The index in Steps of the program of each abbreviation.
+  std::vector<uint32_t> Starts;
+
+public:
+  DWARFAbbreviationSkipTable(const DWARFAbbreviationDeclarationSet &Set,
+                             dwarf::FormParams Params);
+
+  /// Return the program of \p Decl, which belongs to the set.
+  const SkipStep *getProgram(const DWARFAbbreviationDeclaration *Decl) const {
+    return &Steps[Starts[Set.getIndex(Decl)]];
+  }
+};
+
 class DWARFDebugAbbrev {
   using DWARFAbbreviationDeclarationSetMap =
       std::map<uint64_t, DWARFAbbreviationDeclarationSet>;
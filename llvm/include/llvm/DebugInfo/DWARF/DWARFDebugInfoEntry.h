@@ -17,34 +17,56 @@
 namespace llvm {
 
 class DataExtractor;
+class DWARFAbbreviationSkipTable;
 class DWARFUnit;
 
 /// DWARFDebugInfoEntry - A DIE with only the minimum required data.
 class DWARFDebugInfoEntry {
-  /// Offset within the .debug_info of the start of this entry.
-  uint32_t Offset = 0;
-
-  /// The integer depth of this DIE within the compile unit DIEs where the
-  /// compile/type unit DIE has a depth of zero.
-  uint32_t Depth = 0;
+  /// Offset within the .debug_info of the start of this entry in the low
+  /// OffsetBits bits, and the integer depth of this DIE within the compile
+  /// unit DIEs (where the compile/type unit DIE has a depth of zero) in the
+  /// others. The entry stays 16 bytes while addressing sections larger than
+  /// 4 GiB and units nested millions of levels deep.
+  uint64_t OffsetAndDepth = 0;
 
   const DWARFAbbreviationDeclaration *AbbrevDecl = nullptr;
 
+  static constexpr unsigned OffsetBits = 40;
+
+  /// Record \p Offset and \p D, or return false if they do not fit.
+  bool setOffsetAndDepth(uint64_t Offset, uint32_t D) {
+    if (Offset > MaxOffset || D > MaxDepth)
+      return false;
+    OffsetAndDepth = Offset | (uint64_t)D << OffsetBits;
+    return true;
+  }
+
 public:
+  /// The largest offset and depth a DIE can have.
+  static constexpr uint64_t MaxOffset = (uint64_t(1) << OffsetBits) - 1;
+  static constexpr uint32_t MaxDepth = (1u << (64 - OffsetBits)) - 1;
+
   DWARFDebugInfoEntry() = default;
 
   /// Extracts a debug info entry, which is a child of a given unit,
   /// starting at a given offset. If DIE can't be extracted, returns false and
   /// doesn't change OffsetPtr.
-  bool extractFast(const DWARFUnit &U, uint32_t *OffsetPtr);
+  bool extractFast(const DWARFUnit &U, uint64_t *OffsetPtr);
 
-  /// High performance extraction should use this call.
-  bool extractFast(const DWARFUnit &U, uint32_t *OffsetPtr,
-                   const DWARFDataExtractor &DebugInfoData, uint32_t UEndOffset,
+  /// High performance extraction should use this call. Also fails if the
+  /// DIE is nested deeper than MaxDepth.
+  bool extractFast(const DWARFUnit &U, uint64_t *OffsetPtr,
+                   const DWARFDataExtractor &DebugInfoData, uint64_t UEndOffset,
                    uint32_t Depth);
 
-  uint32_t getOffset() const { return Offset; }
-  uint32_t getDepth() const { return Depth; }
+  /// Same as above, but skips the attribute values with the programs of
+  /// \p SkipTable, compiled for the unit's abbreviations.
+  bool extractFast(const DWARFUnit &U, uint64_t *OffsetPtr,
+                   const DWARFDataExtractor &DebugInfoData, uint64_t UEndOffset,
+                   uint32_t Depth, const DWARFAbbreviationSkipTable &SkipTable);
+
+  uint64_t getOffset() const { return OffsetAndDepth & MaxOffset; }
+  uint32_t getDepth() const { return OffsetAndDepth >> OffsetBits; }
 
   dwarf::Tag getTag() const {
     return AbbrevDecl ? AbbrevDecl->getTag() : dwarf::DW_TAG_null;
@@ -57,6 +79,9 @@ public:
   }
 };
 
+static_assert(sizeof(DWARFDebugInfoEntry) <= 16,
+              "the DIE arrays of large units must stay compact");
+
 } // end namespace llvm
 
 #endif // LLVM_DEBUGINFO_DWARFDEBUGINFOENTRY_H
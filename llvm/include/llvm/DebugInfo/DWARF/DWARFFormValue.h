@@ -71,6 +71,8 @@ public:
                                              ArrayRef<uint8_t> D);
   static DWARFFormValue createFromUnit(dwarf::Form F, const DWARFUnit *Unit,
                                        uint32_t *OffsetPtr);
+  static DWARFFormValue createFromUnit(dwarf::Form F, const DWARFUnit *Unit,
+                                       uint64_t *OffsetPtr);
 
   dwarf::Form getForm() const { return Form; }
   uint64_t getRawUValue() const { return Value.uval; }
@@ -97,6 +99,17 @@ public:
     return extractValue(Data, OffsetPtr, FormParams, nullptr, U);
   }
 
+  /// Same as above, with a 64-bit offset, for sections larger than 4 GiB.
+  bool extractValue(const DWARFDataExtractor &Data, uint64_t *OffsetPtr,
+                    dwarf::FormParams FormParams,
+                    const DWARFContext *Context = nullptr,
+                    const DWARFUnit *Unit = nullptr);
+
+  bool extractValue(const DWARFDataExtractor &Data, uint64_t *OffsetPtr,
+                    dwarf::FormParams FormParams, const DWARFUnit *U) {
+    return extractValue(Data, OffsetPtr, FormParams, nullptr, U);
+  }
+
   bool isInlinedCStr() const {
     return Value.data != nullptr && Value.data == (const uint8_t *)Value.cstr;
   }
@@ -147,6 +160,11 @@ public:
                         uint32_t *OffsetPtr,
                         const dwarf::FormParams FormParams);
 
+  /// Same as above, with a 64-bit offset.
+  static bool skipValue(dwarf::Form Form, DataExtractor DebugInfoData,
+                        uint64_t *OffsetPtr,
+                        const dwarf::FormParams FormParams);
+
 private:
   void dumpString(raw_ostream &OS) const;
 };
@@ -394,19 +394,39 @@ public:
   ///     The extracted unsigned integer value.
   uint64_t getULEB128(uint32_t *offset_ptr) const;
 
+  /// \name 64-bit offsets
+  /// The same extractors, for data of more than 4 GiB such as the DWARF64
+  /// debug sections of large binaries.
+  /// @{
+  const char *getCStr(uint64_t *offset_ptr) const;
+  StringRef getCStrRef(uint64_t *OffsetPtr) const;
+  uint64_t getUnsigned(uint64_t *offset_ptr, uint32_t byte_size) const;
+  int64_t getSigned(uint64_t *offset_ptr, uint32_t size) const;
+  uint64_t getAddress(uint64_t *offset_ptr) const {
+    return getUnsigned(offset_ptr, AddressSize);
+  }
+  uint8_t getU8(uint64_t *offset_ptr) const;
+  uint16_t getU16(uint64_t *offset_ptr) const;
+  uint32_t getU24(uint64_t *offset_ptr) const;
+  uint32_t getU32(uint64_t *offset_ptr) const;
+  uint64_t getU64(uint64_t *offset_ptr) const;
+  int64_t getSLEB128(uint64_t *offset_ptr) const;
+  uint64_t getULEB128(uint64_t *offset_ptr) const;
+  /// @}
+
   /// Test the validity of \a offset.
   ///
   /// @return
   ///     \b true if \a offset is a valid offset into the data in this
   ///     object, \b false otherwise.
-  bool isValidOffset(uint32_t offset) const { return Data.size() > offset; }
+  bool isValidOffset(uint64_t offset) const { return Data.size() > offset; }
 
   /// Test the availability of \a length bytes of data from \a offset.
   ///
   /// @return
   ///     \b true if \a offset is a valid offset and there are \a
   ///     length bytes available at that offset, \b false otherwise.
-  bool isValidOffsetForDataOfSize(uint32_t offset, uint32_t length) const {
+  bool isValidOffsetForDataOfSize(uint64_t offset, uint64_t length) const {
     return offset + length >= offset && isValidOffset(offset + length - 1);
   }
 
@@ -417,7 +437,7 @@ public:
   ///     \b true if \a offset is a valid offset and there are enough
   ///     bytes for a pointer available at that offset, \b false
   ///     otherwise.
-  bool isValidOffsetForAddress(uint32_t offset) const {
+  bool isValidOffsetForAddress(uint64_t offset) const {
     return isValidOffsetForDataOfSize(offset, AddressSize);
   }
 };
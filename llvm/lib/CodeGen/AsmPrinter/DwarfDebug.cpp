@@ -37,6 +37,7 @@
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineInstr.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/MachineOperand.h"
 #include "llvm/CodeGen/TargetInstrInfo.h"
 #include "llvm/CodeGen/TargetRegisterInfo.h"
@@ -143,6 +144,12 @@ static cl::opt<DefaultOnOff> DwarfSectionsAsReferences(
                clEnumVal(Enable, "Enabled"), clEnumVal(Disable, "Disabled")),
     cl::init(Default));
 
+static cl::opt<bool> LocationCoverageRemarks(
+    "dwarf-location-coverage-remarks", cl::Hidden,
+    cl::desc("Emit the location coverage of the variables of each function "
+             "as an optimization remark."),
+    cl::init(false));
+
 enum LinkageNameOption {
   DefaultLinkageNames,
   AllLinkageNames,
@@ -1404,6 +1411,122 @@ void DwarfDebug::collectEntityInfo(DwarfCompileUnit &TheCU,
   }
 }
 
+void DwarfDebug::emitLocationCoverageRemark(const MachineFunction *MF,
+                                            const DISubprogram *SP) {
+  // The code size is not known before layout, so the coverage is measured in
+  // instructions. Number them in layout order, ignoring meta instructions.
+  DenseMap<const MachineInstr *, unsigned> InstrIndex;
+  unsigned NumInstrs = 0;
+  for (const MachineBasicBlock &MBB : *MF)
+    for (const MachineInstr &MI : MBB) {
+      InstrIndex[&MI] = NumInstrs;
+      if (!MI.isMetaInstruction())
+        ++NumInstrs;
+    }
+  auto getEnd = [&](const MachineInstr *MI) {
+    return InstrIndex.lookup(MI) + (MI->isMetaInstruction() ? 0 : 1);
+  };
+
+  uint64_t NumVars = 0, NumFullyCovered = 0, NumNotCovered = 0;
+  uint64_t SumCoverage = 0, ScopeInstrs = 0, CoveredInstrs = 0;
+  for (auto &ScopeAndVars : InfoHolder.getScopeVariables()) {
+    LexicalScope *Scope = ScopeAndVars.first;
+    if (Scope->isAbstractScope())
+      continue;
+    SmallVector<std::pair<unsigned, unsigned>, 4> ScopeRanges;
+    unsigned InstrsInScope = 0;
+    for (const InsnRange &R : Scope->getRanges()) {
+      ScopeRanges.push_back({InstrIndex.lookup(R.first), getEnd(R.second)});
+      InstrsInScope += ScopeRanges.back().second - ScopeRanges.back().first;
+    }
+
+    SmallVector<DbgVariable *, 8> Vars(ScopeAndVars.second.Locals);
+    for (const auto &Arg : ScopeAndVars.second.Args)
+      Vars.push_back(Arg.second);
+    for (const DbgVariable *Var : Vars) {
+      if (Var->getVariable()->isArtificial())
+        continue;
+
+      // A frame index or a single DBG_VALUE is valid throughout the scope,
+      // unless that DBG_VALUE is undefined.
+      unsigned Covered = 0;
+      if (Var->hasFrameIndexExprs()) {
+        Covered = InstrsInScope;
+      } else if (const MachineInstr *MInsn = Var->getMInsn()) {
+        if (!MInsn->isUndefDebugValue())
+          Covered = InstrsInScope;
+      } else {
+        auto History =
+            DbgValues.find(InlinedEntity(Var->getVariable(),
+                                         Var->getInlinedAt()));
+        if (History != DbgValues.end()) {
+          // The instructions with a location, in the order they begin. An
+          // entry ending at a clobber covers the clobbering instruction, as
+          // in buildLocationList().
+          SmallVector<std::pair<unsigned, unsigned>, 8> Intervals;
+          const auto &Entries = History->second;
+          for (const auto &Entry : Entries) {
+            if (!Entry.isDbgValue())
+              continue;
+            const MachineInstr *MI = Entry.getInstr();
+            // An undefined location ends the previous value.
+            if (MI->isUndefDebugValue())
+              continue;
+            unsigned End = NumInstrs;
+            if (Entry.isClosed()) {
+              const auto &EndEntry = Entries[Entry.getEndIndex()];
+              End = EndEntry.isClobber()
+                        ? getEnd(EndEntry.getInstr())
+                        : InstrIndex.lookup(EndEntry.getInstr());
+            }
+            Intervals.push_back({InstrIndex.lookup(MI), End});
+          }
+
+          // The entries of the fragments of a variable overlap, so count
+          // each instruction of their union once.
+          auto addCovered = [&](unsigned Begin, unsigned End) {
+            for (const auto &R : ScopeRanges)
+              if (std::max(Begin, R.first) < std::min(End, R.second))
+                Covered += std::min(End, R.second) - std::max(Begin, R.first);
+          };
+          llvm::sort(Intervals);
+          unsigned UnionBegin = 0, UnionEnd = 0;
+          for (const auto &I : Intervals) {
+            if (I.first > UnionEnd) {
+              addCovered(UnionBegin, UnionEnd);
+              UnionBegin = I.first;
+            }
+            UnionEnd = std::max(UnionEnd, I.second);
+          }
+          addCovered(UnionBegin, UnionEnd);
+        }
+      }
+
+      unsigned Coverage = InstrsInScope ? 100 * Covered / InstrsInScope : 0;
+      ++NumVars;
+      if (Coverage == 100)
+        ++NumFullyCovered;
+      else if (Coverage == 0)
+        ++NumNotCovered;
+      SumCoverage += Coverage;
+      ScopeInstrs += InstrsInScope;
+      CoveredInstrs += Covered;
+    }
+  }
+
+  using NV = DiagnosticInfoOptimizationBase::Argument;
+  MachineOptimizationRemarkAnalysis R(DEBUG_TYPE, "LocationCoverage", SP,
+                                      &MF->front());
+  R << NV("NumVars", NumVars) << " variables, "
+    << NV("NumFullyCovered", NumFullyCovered) << " fully covered and "
+    << NV("NumNotCovered", NumNotCovered) << " not covered; "
+    << NV("CoveredInstrs", CoveredInstrs) << " of "
+    << NV("ScopeInstrs", ScopeInstrs)
+    << " instructions in scope have a location (sum of the coverage "
+    << "percentages: " << NV("SumCoverage", SumCoverage) << ")";
+  Asm->ORE->emit(R);
+}
+
 // Process beginning of an instruction.
 void DwarfDebug::beginInstruction(const MachineInstr *MI) {
   DebugHandlerBase::beginInstruction(MI);
@@ -1605,6 +1728,9 @@ void DwarfDebug::endFunctionImpl(const MachineFunction *MF) {
   DenseSet<InlinedEntity> Processed;
   collectEntityInfo(TheCU, SP, Processed);
 
+  if (LocationCoverageRemarks && Asm->ORE)
+    emitLocationCoverageRemark(MF, SP);
+
   // Add the range of this function to the list of ranges for the CU.
   TheCU.addRange(RangeSpan(Asm->getFunctionBegin(), Asm->getFunctionEnd()));
 
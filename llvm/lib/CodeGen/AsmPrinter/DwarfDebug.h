@@ -546,6 +546,11 @@ class DwarfDebug : public DebugHandlerBase {
   void collectEntityInfo(DwarfCompileUnit &TheCU, const DISubprogram *SP,
                          DenseSet<InlinedEntity> &ProcessedVars);
 
+  /// Emit an optimization remark with the location coverage of the
+  /// variables of the current function.
+  void emitLocationCoverageRemark(const MachineFunction *MF,
+                                  const DISubprogram *SP);
+
   /// Build the location list for all DBG_VALUEs in the
   /// function that describe the same variable.
   void buildLocationList(SmallVectorImpl<DebugLocEntry> &DebugLoc,
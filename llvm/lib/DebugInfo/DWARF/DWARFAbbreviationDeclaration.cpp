@@ -148,7 +148,7 @@ DWARFAbbreviationDeclaration::findAttributeIndex(dwarf::Attribute Attr) const {
 }
 
 Optional<DWARFFormValue> DWARFAbbreviationDeclaration::getAttributeValue(
-    const uint32_t DIEOffset, const dwarf::Attribute Attr,
+    const uint64_t DIEOffset, const dwarf::Attribute Attr,
     const DWARFUnit &U) const {
   Optional<uint32_t> MatchAttrIndex = findAttributeIndex(Attr);
   if (!MatchAttrIndex)
@@ -158,7 +158,7 @@ Optional<DWARFFormValue> DWARFAbbreviationDeclaration::getAttributeValue(
 
   // Add the byte size of ULEB that for the abbrev Code so we can start
   // skipping the attribute data.
-  uint32_t Offset = DIEOffset + CodeByteSize;
+  uint64_t Offset = DIEOffset + CodeByteSize;
   uint32_t AttrIndex = 0;
   for (const auto &Spec : AttributeSpecs) {
     if (*MatchAttrIndex == AttrIndex) {
@@ -213,3 +213,55 @@ Optional<size_t> DWARFAbbreviationDeclaration::getFixedAttributesByteSize(
     return FixedAttributeSize->getByteSize(U);
   return None;
 }
+
+void DWARFAbbreviationDeclaration::appendSkipProgram(
+    dwarf::FormParams Params, std::vector<SkipStep> &Program) const {
+  uint32_t FixedBytes = 0;
+  for (const AttributeSpec &Spec : AttributeSpecs) {
+    if (Spec.isImplicitConst())
+      continue;
+    if (Optional<uint8_t> ByteSize = getFixedFormByteSize(Spec.Form, Params)) {
+      FixedBytes += *ByteSize;
+      continue;
+    }
+
+    SkipStep::StepKind Kind;
+    switch (Spec.Form) {
+    case DW_FORM_udata:
+    case DW_FORM_ref_udata:
+    case DW_FORM_strx:
+    case DW_FORM_addrx:
+    case DW_FORM_loclistx:
+    case DW_FORM_rnglistx:
+    case DW_FORM_GNU_addr_index:
+    case DW_FORM_GNU_str_index:
+      Kind = SkipStep::ULEB128;
+      break;
+    case DW_FORM_sdata:
+      Kind = SkipStep::SLEB128;
+      break;
+    case DW_FORM_exprloc:
+    case DW_FORM_block:
+      Kind = SkipStep::BlockULEB128;
+      break;
+    case DW_FORM_block1:
+      Kind = SkipStep::Block1;
+      break;
+    case DW_FORM_block2:
+      Kind = SkipStep::Block2;
+      break;
+    case DW_FORM_block4:
+      Kind = SkipStep::Block4;
+      break;
+    case DW_FORM_string:
+      Kind = SkipStep::CString;
+      break;
+    default:
+      Kind = SkipStep::Other;
+      break;
+    }
+    Program.push_back({FixedBytes, Kind, Spec.Form});
+    FixedBytes = 0;
+  }
+  Program.push_back({FixedBytes, SkipStep::End, dwarf::Form(0)});
+}
@@ -12,14 +12,18 @@
 
 using namespace llvm;
 
-uint64_t DWARFDataExtractor::getRelocatedValue(uint32_t Size, uint32_t *Off,
-                                               uint64_t *SecNdx) const {
+template <typename OffsetT>
+static uint64_t getRelocatedValueImpl(const DWARFDataExtractor &Data,
+                                      const DWARFObject *Obj,
+                                      const DWARFSection *Section,
+                                      uint32_t Size, OffsetT *Off,
+                                      uint64_t *SecNdx) {
   if (SecNdx)
     *SecNdx = object::SectionedAddress::UndefSection;
   if (!Section)
-    return getUnsigned(Off, Size);
+    return Data.getUnsigned(Off, Size);
   Optional<RelocAddrEntry> E = Obj->find(*Section, *Off);
-  uint64_t A = getUnsigned(Off, Size);
+  uint64_t A = Data.getUnsigned(Off, Size);
   if (!E)
     return A;
   if (SecNdx)
@@ -27,6 +31,16 @@ uint64_t DWARFDataExtractor::getRelocatedValue(uint32_t Size, uint32_t *Off,
   return E->Resolver(E->Reloc, E->SymbolValue, A);
 }
 
+uint64_t DWARFDataExtractor::getRelocatedValue(uint32_t Size, uint32_t *Off,
+                                               uint64_t *SecNdx) const {
+  return getRelocatedValueImpl(*this, Obj, Section, Size, Off, SecNdx);
+}
+
+uint64_t DWARFDataExtractor::getRelocatedValue(uint32_t Size, uint64_t *Off,
+                                               uint64_t *SecNdx) const {
+  return getRelocatedValueImpl(*this, Obj, Section, Size, Off, SecNdx);
+}
+
 Optional<uint64_t>
 DWARFDataExtractor::getEncodedPointer(uint32_t *Offset, uint8_t Encoding,
                                       uint64_t PCRelOffset) const {
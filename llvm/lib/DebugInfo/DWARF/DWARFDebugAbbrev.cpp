@@ -19,6 +19,15 @@ DWARFAbbreviationDeclarationSet::DWARFAbbreviationDeclarationSet() {
   clear();
 }
 
+DWARFAbbreviationSkipTable::DWARFAbbreviationSkipTable(
+    const DWARFAbbreviationDeclarationSet &Set, dwarf::FormParams Params)
+    : Set(Set) {
+  for (const DWARFAbbreviationDeclaration &Decl : Set) {
+    Starts.push_back(Steps.size());
+    Decl.appendSkipProgram(Params, Steps);
+  }
+}
+
 void DWARFAbbreviationDeclarationSet::clear() {
   Offset = 0;
   FirstAbbrCode = 0;
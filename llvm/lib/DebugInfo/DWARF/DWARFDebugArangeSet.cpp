@@ -49,9 +49,14 @@ DWARFDebugArangeSet::extract(DataExtractor data, uint32_t *offset_ptr) {
     // descriptor on the target system. This header is followed by a series
     // of tuples. Each tuple consists of an address and a length, each in
     // the size appropriate for an address on the target architecture.
+    // In the 64-bit DWARF format, the length and the offset are 8 bytes.
     HeaderData.Length = data.getU32(offset_ptr);
+    bool IsDWARF64 = HeaderData.Length == UINT32_MAX;
+    if (IsDWARF64)
+      HeaderData.Length = data.getU64(offset_ptr);
     HeaderData.Version = data.getU16(offset_ptr);
-    HeaderData.CuOffset = data.getU32(offset_ptr);
+    HeaderData.CuOffset =
+        IsDWARF64 ? data.getU64(offset_ptr) : data.getU32(offset_ptr);
     HeaderData.AddrSize = data.getU8(offset_ptr);
     HeaderData.SegSize = data.getU8(offset_ptr);
 
@@ -99,9 +104,11 @@ DWARFDebugArangeSet::extract(DataExtractor data, uint32_t *offset_ptr) {
 }
 
 void DWARFDebugArangeSet::dump(raw_ostream &OS) const {
-  OS << format("Address Range Header: length = 0x%8.8x, version = 0x%4.4x, ",
+  OS << format("Address Range Header: length = 0x%8.8" PRIx64
+               ", version = 0x%4.4x, ",
                HeaderData.Length, HeaderData.Version)
-     << format("cu_offset = 0x%8.8x, addr_size = 0x%2.2x, seg_size = 0x%2.2x\n",
+     << format("cu_offset = 0x%8.8" PRIx64
+               ", addr_size = 0x%2.2x, seg_size = 0x%2.2x\n",
                HeaderData.CuOffset, HeaderData.AddrSize, HeaderData.SegSize);
 
   for (const auto &Desc : ArangeDescriptors) {
@@ -18,19 +18,22 @@
 using namespace llvm;
 using namespace dwarf;
 
+constexpr uint64_t DWARFDebugInfoEntry::MaxOffset;
+constexpr uint32_t DWARFDebugInfoEntry::MaxDepth;
+
 bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U,
-                                             uint32_t *OffsetPtr) {
+                                             uint64_t *OffsetPtr) {
   DWARFDataExtractor DebugInfoData = U.getDebugInfoExtractor();
-  const uint32_t UEndOffset = U.getNextUnitOffset();
+  const uint64_t UEndOffset = U.getNextUnitOffset();
   return extractFast(U, OffsetPtr, DebugInfoData, UEndOffset, 0);
 }
 
-bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U, uint32_t *OffsetPtr,
+bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U, uint64_t *OffsetPtr,
                                       const DWARFDataExtractor &DebugInfoData,
-                                      uint32_t UEndOffset, uint32_t D) {
-  Offset = *OffsetPtr;
-  Depth = D;
-  if (Offset >= UEndOffset || !DebugInfoData.isValidOffset(Offset))
+                                      uint64_t UEndOffset, uint32_t D) {
+  const uint64_t Offset = *OffsetPtr;
+  if (Offset >= UEndOffset || !DebugInfoData.isValidOffset(Offset) ||
+      !setOffsetAndDepth(Offset, D))
     return false;
   uint64_t AbbrCode = DebugInfoData.getULEB128(OffsetPtr);
   if (0 == AbbrCode) {
@@ -67,3 +70,72 @@ bool DWARFDebugInfoEntry::extractFast(const DWARFUnit &U, uint32_t *OffsetPtr,
   }
   return true;
 }
+
+bool DWARFDebugInfoEntry::extractFast(
+    const DWARFUnit &U, uint64_t *OffsetPtr,
+    const DWARFDataExtractor &DebugInfoData, uint64_t UEndOffset, uint32_t D,
+    const DWARFAbbreviationSkipTable &SkipTable) {
+  using SkipStep = DWARFAbbreviationDeclaration::SkipStep;
+  const uint64_t Offset = *OffsetPtr;
+  if (Offset >= UEndOffset || !DebugInfoData.isValidOffset(Offset) ||
+      !setOffsetAndDepth(Offset, D))
+    return false;
+  uint64_t AbbrCode = DebugInfoData.getULEB128(OffsetPtr);
+  if (0 == AbbrCode) {
+    // NULL debug tag entry.
+    AbbrevDecl = nullptr;
+    return true;
+  }
+  AbbrevDecl = U.getAbbreviations()->getAbbreviationDeclaration(AbbrCode);
+  if (nullptr == AbbrevDecl) {
+    // Restore the original offset.
+    *OffsetPtr = Offset;
+    return false;
+  }
+
+  for (const SkipStep *Step = SkipTable.getProgram(AbbrevDecl);; ++Step) {
+    *OffsetPtr += Step->FixedBytes;
+    switch (Step->Kind) {
+    case SkipStep::End:
+      return true;
+    case SkipStep::ULEB128:
+      DebugInfoData.getULEB128(OffsetPtr);
+      break;
+    case SkipStep::SLEB128:
+      DebugInfoData.getSLEB128(OffsetPtr);
+      break;
+    case SkipStep::BlockULEB128: {
+      uint64_t Size = DebugInfoData.getULEB128(OffsetPtr);
+      *OffsetPtr += Size;
+      break;
+    }
+    case SkipStep::Block1: {
+      uint8_t Size = DebugInfoData.getU8(OffsetPtr);
+      *OffsetPtr += Size;
+      break;
+    }
+    case SkipStep::Block2: {
+      uint16_t Size = DebugInfoData.getU16(OffsetPtr);
+      *OffsetPtr += Size;
+      break;
+    }
+    case SkipStep::Block4: {
+      uint32_t Size = DebugInfoData.getU32(OffsetPtr);
+      *OffsetPtr += Size;
+      break;
+    }
+    case SkipStep::CString:
+      DebugInfoData.getCStr(OffsetPtr);
+      break;
+    case SkipStep::Other:
+      if (!DWARFFormValue::skipValue(Step->Form, DebugInfoData, OffsetPtr,
+                                     U.getFormParams())) {
+        // We failed to skip this attribute's value, restore the original
+        // offset and return the failure status.
+        *OffsetPtr = Offset;
+        return false;
+      }
+      break;
+    }
+  }
+}
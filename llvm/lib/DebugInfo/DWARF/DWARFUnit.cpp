@@ -21,6 +21,7 @@
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/WithColor.h"
 #include <algorithm>
 #include <cassert>
@@ -66,7 +67,7 @@ void DWARFUnitVector::addUnitsImpl(
   // Lazy initialization of Parser, now that we have all section info.
   if (!Parser) {
     Parser = [=, &Context, &Obj, &Section, &SOS,
-              &LS](uint32_t Offset, DWARFSectionKind SectionKind,
+              &LS](uint64_t Offset, DWARFSectionKind SectionKind,
                    const DWARFSection *CurSection,
                    const DWARFUnitIndex::Entry *IndexEntry)
         -> std::unique_ptr<DWARFUnit> {
@@ -101,7 +102,7 @@ void DWARFUnitVector::addUnitsImpl(
   // within a section, although not necessarily within the object file,
   // even if we do lazy parsing.
   auto I = this->begin();
-  uint32_t Offset = 0;
+  uint64_t Offset = 0;
   while (Data.isValidOffset(Offset)) {
     if (I != this->end() &&
         (&(*I)->getInfoSection() != &Section || (*I)->getOffset() == Offset)) {
@@ -126,11 +127,11 @@ DWARFUnit *DWARFUnitVector::addUnit(std::unique_ptr<DWARFUnit> Unit) {
   return this->insert(I, std::move(Unit))->get();
 }
 
-DWARFUnit *DWARFUnitVector::getUnitForOffset(uint32_t Offset) const {
+DWARFUnit *DWARFUnitVector::getUnitForOffset(uint64_t Offset) const {
   auto end = begin() + getNumInfoUnits();
   auto *CU =
       std::upper_bound(begin(), end, Offset,
-                       [](uint32_t LHS, const std::unique_ptr<DWARFUnit> &RHS) {
+                       [](uint64_t LHS, const std::unique_ptr<DWARFUnit> &RHS) {
                          return LHS < RHS->getNextUnitOffset();
                        });
   if (CU != end && (*CU)->getOffset() <= Offset)
@@ -233,7 +234,7 @@ Optional<uint64_t> DWARFUnit::getStringOffsetSectionItem(uint32_t Index) const {
 
 bool DWARFUnitHeader::extract(DWARFContext &Context,
                               const DWARFDataExtractor &debug_info,
-                              uint32_t *offset_ptr,
+                              uint64_t *offset_ptr,
                               DWARFSectionKind SectionKind,
                               const DWARFUnitIndex *Index,
                               const DWARFUnitIndex::Entry *Entry) {
@@ -277,7 +278,8 @@ bool DWARFUnitHeader::extract(DWARFContext &Context,
   }
   if (isTypeUnit()) {
     TypeHash = debug_info.getU64(offset_ptr);
-    TypeOffset = debug_info.getU32(offset_ptr);
+    TypeOffset = debug_info.getUnsigned(offset_ptr,
+                                        FormParams.getDwarfOffsetByteSize());
   } else if (UnitType == DW_UT_split_compile || UnitType == DW_UT_skeleton)
     DWOId = debug_info.getU64(offset_ptr);
 
@@ -323,13 +325,13 @@ parseRngListTableHeader(DWARFDataExtractor &DA, uint32_t Offset) {
   return Table;
 }
 
-Error DWARFUnit::extractRangeList(uint32_t RangeListOffset,
+Error DWARFUnit::extractRangeList(uint64_t RangeListOffset,
                                   DWARFDebugRangeList &RangeList) const {
   // Require that compile unit is extracted.
   assert(!DieArray.empty());
   DWARFDataExtractor RangesData(Context.getDWARFObj(), *RangeSection,
                                 isLittleEndian, getAddressByteSize());
-  uint32_t ActualRangeListOffset = RangeSectionBase + RangeListOffset;
+  uint64_t ActualRangeListOffset = RangeSectionBase + RangeListOffset;
   return RangeList.extract(RangesData, &ActualRangeListOffset);
 }
 
@@ -354,15 +356,27 @@ void DWARFUnit::extractDIEsToVector(
 
   // Set the offset to that of the first DIE and calculate the start of the
   // next compilation unit header.
-  uint32_t DIEOffset = getOffset() + getHeaderSize();
-  uint32_t NextCUOffset = getNextUnitOffset();
+  uint64_t DIEOffset = getOffset() + getHeaderSize();
+  uint64_t NextCUOffset = getNextUnitOffset();
   DWARFDebugInfoEntry DIE;
   DWARFDataExtractor DebugInfoData = getDebugInfoExtractor();
   uint32_t Depth = 0;
   bool IsCUDie = true;
 
-  while (DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset,
-                         Depth)) {
+  // Unless only the unit DIE is needed, compile the skipping of the attribute
+  // values of each abbreviation once for the whole unit.
+  Optional<DWARFAbbreviationSkipTable> SkipTable;
+  if (AppendNonCUDies && getAbbreviations())
+    SkipTable.emplace(*getAbbreviations(), getFormParams());
+  auto ExtractNextDIE = [&]() {
+    if (SkipTable)
+      return DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset,
+                             Depth, *SkipTable);
+    return DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset,
+                           Depth);
+  };
+
+  while (ExtractNextDIE()) {
     if (IsCUDie) {
       if (AppendCUDie)
         Dies.push_back(DIE);
@@ -396,8 +410,142 @@ void DWARFUnit::extractDIEsToVector(
   // unit header).
   if (DIEOffset > NextCUOffset)
     WithColor::warning() << format("DWARF compile unit extends beyond its "
-                                   "bounds cu 0x%8.8x at 0x%8.8x\n",
+                                   "bounds cu 0x%8.8" PRIx64 " at 0x%8.8" PRIx64
+                                   "\n",
                                    getOffset(), DIEOffset);
+  else if (Depth > DWARFDebugInfoEntry::MaxDepth)
+    WithColor::warning() << format("DWARF compile unit nests DIEs deeper than "
+                                   "%u levels cu 0x%8.8" PRIx64
+                                   " at 0x%8.8" PRIx64 "\n",
+                                   DWARFDebugInfoEntry::MaxDepth, getOffset(),
+                                   DIEOffset);
+}
+
+bool DWARFUnit::findChildSegments(uint32_t MinSegmentSize,
+                                  const DWARFAbbreviationSkipTable &SkipTable,
+                                  std::vector<uint64_t> &Starts) const {
+  uint64_t DIEOffset = getOffset() + getHeaderSize();
+  uint64_t NextCUOffset = getNextUnitOffset();
+  DWARFDebugInfoEntry DIE;
+  DWARFDataExtractor DebugInfoData = getDebugInfoExtractor();
+
+  // Step over the unit DIE, then walk its children.
+  if (!DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset, 0,
+                       SkipTable) ||
+      !DIE.hasChildren())
+    return false;
+  uint64_t SegmentStart = DIEOffset;
+  Starts.push_back(DIEOffset);
+  while (true) {
+    uint64_t ChildOffset = DIEOffset;
+    if (!DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset, 1,
+                         SkipTable))
+      return false;
+    // The NULL entry ending the children of the unit DIE.
+    if (!DIE.getAbbreviationDeclarationPtr())
+      return true;
+
+    if (DIE.hasChildren()) {
+      // Jump to the next child if the producer tells where it is, and skip
+      // over the subtree otherwise. A wrong DW_AT_sibling is caught when the
+      // segments are decoded.
+      Optional<uint64_t> Sibling =
+          toReference(DIE.getAbbreviationDeclarationPtr()->getAttributeValue(
+              ChildOffset, DW_AT_sibling, *this));
+      if (Sibling && *Sibling > DIEOffset && *Sibling < NextCUOffset) {
+        DIEOffset = *Sibling;
+      } else {
+        for (uint32_t Depth = 2; Depth > 1;) {
+          if (!DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset,
+                               Depth, SkipTable))
+            return false;
+          if (DIE.hasChildren())
+            ++Depth;
+          else if (!DIE.getAbbreviationDeclarationPtr())
+            --Depth;
+        }
+      }
+    }
+
+    if (DIEOffset - SegmentStart >= MinSegmentSize) {
+      Starts.push_back(DIEOffset);
+      SegmentStart = DIEOffset;
+    }
+  }
+}
+
+size_t DWARFUnit::extractDIEsInParallel(ThreadPool &Pool,
+                                        uint32_t MinSegmentSize) {
+  if (DieArray.size() > 1)
+    return 0; // Already parsed.
+
+  // The unit DIE, and the values read from it, come from the serial path.
+  extractDIEsIfNeeded(/*CUDieOnly=*/true);
+  if (DieArray.empty() || !getAbbreviations())
+    return extractDIEsIfNeeded(false);
+  DWARFAbbreviationSkipTable SkipTable(*getAbbreviations(), getFormParams());
+  std::vector<uint64_t> Starts;
+  if (!findChildSegments(MinSegmentSize, SkipTable, Starts) ||
+      Starts.size() < 2)
+    return extractDIEsIfNeeded(false);
+
+  struct Segment {
+    std::vector<DWARFDebugInfoEntry> Dies;
+    uint64_t EndOffset = 0;
+    bool Valid = false;
+  };
+  std::vector<Segment> Segments(Starts.size());
+  const uint64_t NextCUOffset = getNextUnitOffset();
+  auto ExtractSegment = [&](size_t Index) {
+    Segment &S = Segments[Index];
+    const bool IsLast = Index + 1 == Starts.size();
+    uint64_t DIEOffset = Starts[Index];
+    const uint64_t EndOffset = IsLast ? NextCUOffset : Starts[Index + 1];
+    DWARFDebugInfoEntry DIE;
+    DWARFDataExtractor DebugInfoData = getDebugInfoExtractor();
+    uint32_t Depth = 1;
+    S.Dies.reserve((EndOffset - DIEOffset) / 14);
+    // The loop of extractDIEsToVector(), from a child of the unit DIE.
+    while ((IsLast || DIEOffset < EndOffset) &&
+           DIE.extractFast(*this, &DIEOffset, DebugInfoData, NextCUOffset,
+                           Depth, SkipTable)) {
+      S.Dies.push_back(DIE);
+      if (DIE.hasChildren())
+        ++Depth;
+      else if (!DIE.getAbbreviationDeclarationPtr() && --Depth == 0)
+        break;
+    }
+    S.EndOffset = DIEOffset;
+    // Only the last segment may end the children of the unit DIE. The
+    // others must end right at the next one, back at the depth of the
+    // children, for the DIEs to be those of the serial path.
+    S.Valid = IsLast || (DIEOffset == EndOffset && Depth == 1);
+  };
+
+  // The calling thread decodes the first segment.
+  std::vector<std::shared_future<void>> Futures;
+  for (size_t I = 1; I < Segments.size(); ++I)
+    Futures.push_back(Pool.async(ExtractSegment, I));
+  ExtractSegment(0);
+  for (std::shared_future<void> &Future : Futures)
+    Future.wait();
+
+  if (!llvm::all_of(Segments, [](const Segment &S) { return S.Valid; }))
+    return extractDIEsIfNeeded(false);
+
+  size_t NumDies = DieArray.size();
+  for (const Segment &S : Segments)
+    NumDies += S.Dies.size();
+  DieArray.reserve(NumDies);
+  for (const Segment &S : Segments)
+    DieArray.insert(DieArray.end(), S.Dies.begin(), S.Dies.end());
+
+  if (Segments.back().EndOffset > NextCUOffset)
+    WithColor::warning() << format("DWARF compile unit extends beyond its "
+                                   "bounds cu 0x%8.8" PRIx64 " at 0x%8.8" PRIx64
+                                   "\n",
+                                   getOffset(), Segments.back().EndOffset);
+  return DieArray.size();
 }
 
 size_t DWARFUnit::extractDIEsIfNeeded(bool CUDieOnly) {
@@ -541,7 +689,7 @@ void DWARFUnit::clearDIEs(bool KeepCUDie) {
 }
 
 Expected<DWARFAddressRangesVector>
-DWARFUnit::findRnglistFromOffset(uint32_t Offset) {
+DWARFUnit::findRnglistFromOffset(uint64_t Offset) {
   if (getVersion() <= 4) {
     DWARFDebugRangeList RangeList;
     if (Error E = extractRangeList(Offset, RangeList))
@@ -12,11 +12,11 @@
 #include "llvm/Support/SwapByteOrder.h"
 using namespace llvm;
 
-template <typename T>
-static T getU(uint32_t *offset_ptr, const DataExtractor *de,
+template <typename T, typename OffsetT>
+static T getU(OffsetT *offset_ptr, const DataExtractor *de,
               bool isLittleEndian, const char *Data) {
   T val = 0;
-  uint32_t offset = *offset_ptr;
+  OffsetT offset = *offset_ptr;
   if (de->isValidOffsetForDataOfSize(offset, sizeof(val))) {
     std::memcpy(&val, &Data[offset], sizeof(val));
     if (sys::IsLittleEndianHost != isLittleEndian)
@@ -50,6 +50,10 @@ uint8_t DataExtractor::getU8(uint32_t *offset_ptr) const {
   return getU<uint8_t>(offset_ptr, this, IsLittleEndian, Data.data());
 }
 
+uint8_t DataExtractor::getU8(uint64_t *offset_ptr) const {
+  return getU<uint8_t>(offset_ptr, this, IsLittleEndian, Data.data());
+}
+
 uint8_t *
 DataExtractor::getU8(uint32_t *offset_ptr, uint8_t *dst, uint32_t count) const {
   return getUs<uint8_t>(offset_ptr, dst, count, this, IsLittleEndian,
@@ -61,6 +65,10 @@ uint16_t DataExtractor::getU16(uint32_t *offset_ptr) const {
   return getU<uint16_t>(offset_ptr, this, IsLittleEndian, Data.data());
 }
 
+uint16_t DataExtractor::getU16(uint64_t *offset_ptr) const {
+  return getU<uint16_t>(offset_ptr, this, IsLittleEndian, Data.data());
+}
+
 uint16_t *DataExtractor::getU16(uint32_t *offset_ptr, uint16_t *dst,
                                 uint32_t count) const {
   return getUs<uint16_t>(offset_ptr, dst, count, this, IsLittleEndian,
@@ -74,10 +82,20 @@ uint32_t DataExtractor::getU24(uint32_t *offset_ptr) const {
   return ExtractedVal.getAsUint32(sys::IsLittleEndianHost);
 }
 
+uint32_t DataExtractor::getU24(uint64_t *offset_ptr) const {
+  uint24_t ExtractedVal =
+      getU<uint24_t>(offset_ptr, this, IsLittleEndian, Data.data());
+  return ExtractedVal.getAsUint32(sys::IsLittleEndianHost);
+}
+
 uint32_t DataExtractor::getU32(uint32_t *offset_ptr) const {
   return getU<uint32_t>(offset_ptr, this, IsLittleEndian, Data.data());
 }
 
+uint32_t DataExtractor::getU32(uint64_t *offset_ptr) const {
+  return getU<uint32_t>(offset_ptr, this, IsLittleEndian, Data.data());
+}
+
 uint32_t *DataExtractor::getU32(uint32_t *offset_ptr, uint32_t *dst,
                                 uint32_t count) const {
   return getUs<uint32_t>(offset_ptr, dst, count, this, IsLittleEndian,
@@ -88,72 +106,105 @@ uint64_t DataExtractor::getU64(uint32_t *offset_ptr) const {
   return getU<uint64_t>(offset_ptr, this, IsLittleEndian, Data.data());
 }
 
+uint64_t DataExtractor::getU64(uint64_t *offset_ptr) const {
+  return getU<uint64_t>(offset_ptr, this, IsLittleEndian, Data.data());
+}
+
 uint64_t *DataExtractor::getU64(uint32_t *offset_ptr, uint64_t *dst,
                                 uint32_t count) const {
   return getUs<uint64_t>(offset_ptr, dst, count, this, IsLittleEndian,
                         Data.data());
 }
 
-uint64_t
-DataExtractor::getUnsigned(uint32_t *offset_ptr, uint32_t byte_size) const {
+template <typename OffsetT>
+static uint64_t getUnsignedImpl(const DataExtractor &de, OffsetT *offset_ptr,
+                                uint32_t byte_size) {
   switch (byte_size) {
   case 1:
-    return getU8(offset_ptr);
+    return de.getU8(offset_ptr);
   case 2:
-    return getU16(offset_ptr);
+    return de.getU16(offset_ptr);
   case 4:
-    return getU32(offset_ptr);
+    return de.getU32(offset_ptr);
   case 8:
-    return getU64(offset_ptr);
+    return de.getU64(offset_ptr);
   }
   llvm_unreachable("getUnsigned unhandled case!");
 }
 
-int64_t
-DataExtractor::getSigned(uint32_t *offset_ptr, uint32_t byte_size) const {
+uint64_t
+DataExtractor::getUnsigned(uint32_t *offset_ptr, uint32_t byte_size) const {
+  return getUnsignedImpl(*this, offset_ptr, byte_size);
+}
+
+uint64_t
+DataExtractor::getUnsigned(uint64_t *offset_ptr, uint32_t byte_size) const {
+  return getUnsignedImpl(*this, offset_ptr, byte_size);
+}
+
+template <typename OffsetT>
+static int64_t getSignedImpl(const DataExtractor &de, OffsetT *offset_ptr,
+                             uint32_t byte_size) {
   switch (byte_size) {
   case 1:
-    return (int8_t)getU8(offset_ptr);
+    return (int8_t)de.getU8(offset_ptr);
   case 2:
-    return (int16_t)getU16(offset_ptr);
+    return (int16_t)de.getU16(offset_ptr);
   case 4:
-    return (int32_t)getU32(offset_ptr);
+    return (int32_t)de.getU32(offset_ptr);
   case 8:
-    return (int64_t)getU64(offset_ptr);
+    return (int64_t)de.getU64(offset_ptr);
   }
   llvm_unreachable("getSigned unhandled case!");
 }
 
+int64_t
+DataExtractor::getSigned(uint32_t *offset_ptr, uint32_t byte_size) const {
+  return getSignedImpl(*this, offset_ptr, byte_size);
+}
+
+int64_t
+DataExtractor::getSigned(uint64_t *offset_ptr, uint32_t byte_size) const {
+  return getSignedImpl(*this, offset_ptr, byte_size);
+}
+
+template <typename OffsetT>
+static StringRef getCStrImpl(StringRef Data, OffsetT *OffsetPtr) {
+  OffsetT Start = *OffsetPtr;
+  StringRef::size_type Pos = Data.find('\0', Start);
+  if (Pos == StringRef::npos)
+    return StringRef();
+  *OffsetPtr = Pos + 1;
+  return StringRef(Data.data() + Start, Pos - Start);
+}
+
 const char *DataExtractor::getCStr(uint32_t *offset_ptr) const {
-  uint32_t offset = *offset_ptr;
-  StringRef::size_type pos = Data.find('\0', offset);
-  if (pos != StringRef::npos) {
-    *offset_ptr = pos + 1;
-    return Data.data() + offset;
-  }
-  return nullptr;
+  return getCStrImpl(Data, offset_ptr).data();
+}
+
+const char *DataExtractor::getCStr(uint64_t *offset_ptr) const {
+  return getCStrImpl(Data, offset_ptr).data();
 }
 
 StringRef DataExtractor::getCStrRef(uint32_t *OffsetPtr) const {
-  uint32_t Start = *OffsetPtr;
-  StringRef::size_type Pos = Data.find('\0', Start);
-  if (Pos != StringRef::npos) {
-    *OffsetPtr = Pos + 1;
-    return StringRef(Data.data() + Start, Pos - Start);
-  }
-  return StringRef();
+  return getCStrImpl(Data, OffsetPtr);
 }
 
-uint64_t DataExtractor::getULEB128(uint32_t *offset_ptr) const {
+StringRef DataExtractor::getCStrRef(uint64_t *OffsetPtr) const {
+  return getCStrImpl(Data, OffsetPtr);
+}
+
+template <typename OffsetT>
+static uint64_t getULEB128Impl(StringRef Data, OffsetT *offset_ptr) {
   uint64_t result = 0;
   if (Data.empty())
     return 0;
 
   unsigned shift = 0;
-  uint32_t offset = *offset_ptr;
+  OffsetT offset = *offset_ptr;
   uint8_t byte = 0;
 
-  while (isValidOffset(offset)) {
+  while (Data.size() > offset) {
     byte = Data[offset++];
     result |= uint64_t(byte & 0x7f) << shift;
     shift += 7;
@@ -165,16 +216,25 @@ uint64_t DataExtractor::getULEB128(uint32_t *offset_ptr) const {
   return result;
 }
 
-int64_t DataExtractor::getSLEB128(uint32_t *offset_ptr) const {
+uint64_t DataExtractor::getULEB128(uint32_t *offset_ptr) const {
+  return getULEB128Impl(Data, offset_ptr);
+}
+
+uint64_t DataExtractor::getULEB128(uint64_t *offset_ptr) const {
+  return getULEB128Impl(Data, offset_ptr);
+}
+
+template <typename OffsetT>
+static int64_t getSLEB128Impl(StringRef Data, OffsetT *offset_ptr) {
   int64_t result = 0;
   if (Data.empty())
     return 0;
 
   unsigned shift = 0;
-  uint32_t offset = *offset_ptr;
+  OffsetT offset = *offset_ptr;
   uint8_t byte = 0;
 
-  while (isValidOffset(offset)) {
+  while (Data.size() > offset) {
     byte = Data[offset++];
     result |= uint64_t(byte & 0x7f) << shift;
     shift += 7;
@@ -189,3 +249,11 @@ int64_t DataExtractor::getSLEB128(uint32_t *offset_ptr) const {
   *offset_ptr = offset;
   return result;
 }
+
+int64_t DataExtractor::getSLEB128(uint32_t *offset_ptr) const {
+  return getSLEB128Impl(Data, offset_ptr);
+}
+
+int64_t DataExtractor::getSLEB128(uint64_t *offset_ptr) const {
+  return getSLEB128Impl(Data, offset_ptr);
+}
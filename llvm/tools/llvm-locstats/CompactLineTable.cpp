@@ -0,0 +1,99 @@
+//===-- CompactLineTable.cpp - Address, file and line rows ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "CompactLineTable.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+
+using namespace llvm;
+using namespace locstats;
+
+CompactLineTable::CompactLineTable(const DWARFDebugLine::LineTable &LineTable,
+                                   const char *CompDir) {
+  Rows.reserve(LineTable.Rows.size());
+  for (const DWARFDebugLine::Sequence &Seq : LineTable.Sequences) {
+    if (!Seq.isValid())
+      continue;
+    Sequence Current = {Seq.SectionIndex, Seq.LowPC, Seq.HighPC,
+                        (uint32_t)Rows.size(), 0};
+    for (uint32_t I = Seq.FirstRowIndex; I < Seq.LastRowIndex; ++I) {
+      const DWARFDebugLine::Row &Row = LineTable.Rows[I];
+      uint64_t Address = Row.Address.Address;
+      if (Row.EndSequence || Address < Current.LowPC)
+        continue;
+      // Start a new sequence where the delta no longer fits.
+      if (Address - Current.LowPC > UINT32_MAX) {
+        Current.HighPC = Address;
+        Current.LastRow = Rows.size();
+        Sequences.push_back(Current);
+        Current.LowPC = Address;
+        Current.HighPC = Seq.HighPC;
+        Current.FirstRow = Rows.size();
+      }
+      uint32_t Flags = (Row.IsStmt ? IsStmt : 0u) |
+                       (Row.PrologueEnd ? PrologueEnd : 0u) |
+                       (Row.EpilogueBegin ? EpilogueBegin : 0u);
+      Rows.push_back({(uint32_t)(Address - Current.LowPC), Row.Line,
+                      (Row.File & FileMask) | Flags});
+    }
+    Current.LastRow = Rows.size();
+    if (Current.FirstRow != Current.LastRow)
+      Sequences.push_back(Current);
+  }
+  Rows.shrink_to_fit();
+  llvm::sort(Sequences, [](const Sequence &LHS, const Sequence &RHS) {
+    return std::make_pair(LHS.SectionIndex, LHS.LowPC) <
+           std::make_pair(RHS.SectionIndex, RHS.LowPC);
+  });
+
+  // The file indices start at 1 before DWARF v5, and at 0 since.
+  FileNames.resize(LineTable.Prologue.FileNames.size() + 1);
+  for (uint32_t I = 0; I < FileNames.size(); ++I)
+    if (LineTable.hasFileAtIndex(I))
+      LineTable.getFileNameByIndex(
+          I, CompDir, DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath,
+          FileNames[I]);
+}
+
+const CompactLineTable *LineTableCache::get(DWARFUnit &U) {
+  auto StmtList = dwarf::toSectionOffset(
+      U.getUnitDIE().find(dwarf::DW_AT_stmt_list));
+  if (!StmtList)
+    return nullptr;
+  uint64_t Offset = *StmtList + U.getLineTableOffset();
+  if (Offset >= U.getLineSection().Data.size())
+    return nullptr;
+
+  Entry *E;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    std::unique_ptr<Entry> &Slot = Entries[Offset];
+    if (!Slot)
+      Slot = llvm::make_unique<Entry>();
+    E = Slot.get();
+  }
+
+  std::call_once(E->Parsed, [&] {
+    // Each thread parses into its own LineTable, from the section data that
+    // is not modified once the context is created.
+    DWARFContext &Ctx = U.getContext();
+    DWARFDataExtractor LineData(Ctx.getDWARFObj(), U.getLineSection(),
+                                Ctx.isLittleEndian(), U.getAddressByteSize());
+    DWARFDebugLine::LineTable LineTable;
+    uint32_t ParseOffset = Offset;
+    if (Error Err = LineTable.parse(
+            LineData, &ParseOffset, Ctx, &U,
+            [](Error Warning) { consumeError(std::move(Warning)); })) {
+      consumeError(std::move(Err));
+      return;
+    }
+    E->Table =
+        llvm::make_unique<CompactLineTable>(LineTable, U.getCompilationDir());
+  });
+  return E->Table.get();
+}
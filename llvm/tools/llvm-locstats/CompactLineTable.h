@@ -0,0 +1,155 @@
+//===-- CompactLineTable.h - Address, file and line rows --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a compact form of the line tables, for the consumers that
+// only need the address, file and line of the rows, and a cache of them that
+// parses the line programs of several units concurrently.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_COMPACTLINETABLE_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_COMPACTLINETABLE_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugLine.h"
+#include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace locstats {
+
+/// The rows of a line table, reduced to their address, file, line and flags.
+///
+/// A DWARFDebugLine::Row takes 32 bytes, half of them for its sectioned
+/// address. Here a row takes 12: its address is stored as a 32-bit delta from
+/// the start of its sequence, which holds the section index, and the flags
+/// are packed in the top bits of the file index. The end of sequence rows are
+/// folded into the sequences. The file names are resolved up front, so the
+/// table does not refer back to the DWARFContext.
+class CompactLineTable {
+public:
+  enum RowFlags : uint32_t {
+    IsStmt = 1u << 31,
+    PrologueEnd = 1u << 30,
+    EpilogueBegin = 1u << 29,
+    FileMask = EpilogueBegin - 1
+  };
+
+  CompactLineTable(const DWARFDebugLine::LineTable &LineTable,
+                   const char *CompDir);
+
+  /// Call \p Fn(Address, File, Line, Flags) for each row covering some of
+  /// [LowPC, HighPC) in section \p SectionIndex, with the first address of
+  /// the row within the range, in address order within each sequence.
+  template <typename Fn>
+  void forEachRow(uint64_t LowPC, uint64_t HighPC, uint64_t SectionIndex,
+                  Fn F) const;
+
+  /// Return the name of the file at \p FileIndex, or "<unknown>".
+  StringRef getFileName(uint32_t FileIndex) const {
+    if (FileIndex < FileNames.size() && !FileNames[FileIndex].empty())
+      return FileNames[FileIndex];
+    return "<unknown>";
+  }
+
+  size_t size() const { return Rows.size(); }
+
+private:
+  struct Row {
+    uint32_t AddressDelta;
+    uint32_t Line;
+    uint32_t FileAndFlags;
+  };
+  struct Sequence {
+    uint64_t SectionIndex;
+    uint64_t LowPC;
+    uint64_t HighPC;
+    /// The rows are [FirstRow, LastRow).
+    uint32_t FirstRow;
+    uint32_t LastRow;
+  };
+
+  std::vector<Row> Rows;
+  /// Sorted by section, then by address.
+  std::vector<Sequence> Sequences;
+  std::vector<std::string> FileNames;
+};
+
+template <typename Fn>
+void CompactLineTable::forEachRow(uint64_t LowPC, uint64_t HighPC,
+                                  uint64_t SectionIndex, Fn F) const {
+  if (LowPC >= HighPC)
+    return;
+  auto Seq = Sequences.begin();
+  while (Seq != Sequences.end()) {
+    // The sequences of one section do not overlap, so both their starts and
+    // their ends are sorted. Without a section index, look in each section.
+    uint64_t Section =
+        SectionIndex == object::SectionedAddress::UndefSection
+            ? Seq->SectionIndex
+            : SectionIndex;
+    auto SectionBegin = std::partition_point(
+        Seq, Sequences.end(),
+        [&](const Sequence &Other) { return Other.SectionIndex < Section; });
+    auto SectionEnd = std::partition_point(
+        SectionBegin, Sequences.end(),
+        [&](const Sequence &Other) { return Other.SectionIndex <= Section; });
+    for (auto S = std::partition_point(
+             SectionBegin, SectionEnd,
+             [&](const Sequence &Other) { return Other.HighPC <= LowPC; });
+         S != SectionEnd && S->LowPC < HighPC; ++S) {
+      // The last row starting at or before LowPC covers it.
+      const Row *Begin = Rows.data() + S->FirstRow;
+      const Row *End = Rows.data() + S->LastRow;
+      const Row *R = std::partition_point(Begin, End, [&](const Row &Other) {
+        return S->LowPC + Other.AddressDelta <= LowPC;
+      });
+      if (R != Begin)
+        --R;
+      for (; R != End && S->LowPC + R->AddressDelta < HighPC; ++R)
+        F(std::max(S->LowPC + R->AddressDelta, LowPC),
+          R->FileAndFlags & FileMask, R->Line, R->FileAndFlags & ~FileMask);
+    }
+    if (SectionIndex != object::SectionedAddress::UndefSection)
+      break;
+    Seq = SectionEnd;
+  }
+}
+
+/// The compact line tables of the units of a DWARFContext.
+///
+/// DWARFContext::getLineTableForUnit() fills a single std::map, so it may
+/// only be called from one thread at a time. Here, each table is parsed on
+/// its own by the first thread that asks for it, while the threads asking
+/// for the same table wait, and the lock is only held to find the entry.
+class LineTableCache {
+public:
+  /// Return the line table of \p U, or null if it has none or it cannot be
+  /// parsed. The unit DIE must have been extracted.
+  const CompactLineTable *get(DWARFUnit &U);
+
+private:
+  struct Entry {
+    std::once_flag Parsed;
+    std::unique_ptr<CompactLineTable> Table;
+  };
+
+  std::mutex Mutex;
+  DenseMap<uint64_t, std::unique_ptr<Entry>> Entries;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_COMPACTLINETABLE_H
@@ -0,0 +1,69 @@
+//===-- CoverageSketch.cpp - Mergeable coverage distribution --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "CoverageSketch.h"
+#include <cassert>
+#include <cmath>
+
+using namespace llvm;
+using namespace locstats;
+
+void CoverageSketch::merge(const CoverageSketch &Other) {
+  for (unsigned I = 0; I < NumBins; ++I)
+    Bins[I] += Other.Bins[I];
+  Total += Other.Total;
+}
+
+uint64_t CoverageSketch::getWeightForPercent(unsigned Percent) const {
+  assert(Percent <= 100 && "Coverage is a percentage");
+  if (Percent == 100)
+    return Bins[NumBins - 1];
+  uint64_t Weight = 0;
+  for (unsigned I = Percent * 10, E = I + 10; I < E; ++I)
+    Weight += Bins[I];
+  return Weight;
+}
+
+double CoverageSketch::getQuantile(double Q) const {
+  if (!Total)
+    return 0;
+  uint64_t Rank = std::max<uint64_t>(1, (uint64_t)std::ceil(Q * Total));
+  uint64_t Seen = 0;
+  for (unsigned I = 0; I < NumBins; ++I) {
+    Seen += Bins[I];
+    if (Seen >= Rank)
+      return I / 10.0;
+  }
+  return 100;
+}
+
+json::Value CoverageSketch::toJSON() const {
+  json::Array Result;
+  for (unsigned I = 0; I < NumBins; ++I)
+    if (Bins[I])
+      Result.push_back(json::Array{I, (int64_t)Bins[I]});
+  return std::move(Result);
+}
+
+bool CoverageSketch::fromJSON(const json::Value &V) {
+  const json::Array *Pairs = V.getAsArray();
+  if (!Pairs)
+    return false;
+  for (const json::Value &Pair : *Pairs) {
+    const json::Array *BinAndWeight = Pair.getAsArray();
+    if (!BinAndWeight || BinAndWeight->size() != 2)
+      return false;
+    Optional<int64_t> Bin = (*BinAndWeight)[0].getAsInteger();
+    Optional<int64_t> Weight = (*BinAndWeight)[1].getAsInteger();
+    if (!Bin || !Weight || *Bin < 0 || *Bin >= NumBins || *Weight < 0)
+      return false;
+    Bins[*Bin] += *Weight;
+    Total += *Weight;
+  }
+  return true;
+}
@@ -0,0 +1,76 @@
+//===-- CoverageSketch.h - Mergeable coverage distribution ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a mergeable quantile sketch of per-variable location
+// coverage.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_COVERAGESKETCH_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_COVERAGESKETCH_H
+
+#include "llvm/Support/JSON.h"
+#include <array>
+#include <cstdint>
+
+namespace llvm {
+namespace locstats {
+
+/// A weighted distribution of coverage percentages.
+///
+/// Coverage is bounded to [0, 100], so the sketch keeps fixed bins of 0.1%.
+/// Quantiles are exact to the bin, sketches of any number of threads, shards
+/// or binaries are merged by adding the bins, and no per-variable data is
+/// retained.
+class CoverageSketch {
+public:
+  /// Number of bins: 0.0%, 0.1%, ..., 99.9% and 100%.
+  static const unsigned NumBins = 1001;
+
+  /// Record a variable with \p Coverage percent and the given weight.
+  void add(double Coverage, uint64_t Weight = 1) {
+    Bins[getBin(Coverage)] += Weight;
+    Total += Weight;
+  }
+
+  void merge(const CoverageSketch &Other);
+
+  uint64_t getTotal() const { return Total; }
+
+  /// Return the weight of the variables whose coverage, rounded down to a
+  /// whole percent, is \p Percent.
+  uint64_t getWeightForPercent(unsigned Percent) const;
+
+  /// Return the coverage C such that a \p Q fraction of the weight has
+  /// coverage below or equal to C, rounded down to the bin.
+  double getQuantile(double Q) const;
+
+  /// Serialize the non-empty bins as [bin, weight] pairs.
+  json::Value toJSON() const;
+  /// Read the bins back from toJSON() output. Returns false on malformed
+  /// input.
+  bool fromJSON(const json::Value &V);
+
+private:
+  static unsigned getBin(double Coverage) {
+    // This also catches NaN, the coverage of an empty scope.
+    if (!(Coverage > 0))
+      return 0;
+    if (Coverage >= 100)
+      return NumBins - 1;
+    return (unsigned)(Coverage * 10);
+  }
+
+  std::array<uint64_t, NumBins> Bins{};
+  uint64_t Total = 0;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_COVERAGESKETCH_H
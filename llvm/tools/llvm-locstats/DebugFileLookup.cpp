@@ -0,0 +1,308 @@
+//===-- DebugFileLookup.cpp - Separate debug file discovery ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DebugFileLookup.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Support/CRC.h"
+#include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "locstats"
+using namespace llvm;
+using namespace object;
+using namespace locstats;
+
+/// The first line of a build-id index file. Version 1 had no scan stamp, and
+/// is still read.
+static const char IndexHeader[] = "# llvm-locstats build-id index v2";
+static const char IndexHeaderV1[] = "# llvm-locstats build-id index v1";
+/// The line of the index that holds the time of the scan.
+static const char ScanStampPrefix[] = "# scanned ";
+
+/// Return the section name without the leading '.', '_' and the 'z' of
+/// compressed debug sections.
+static StringRef getSectionName(const SectionRef &Section) {
+  StringRef Name;
+  if (Section.getName(Name))
+    return StringRef();
+  Name = Name.substr(Name.find_first_not_of("._"));
+  return Name;
+}
+
+bool locstats::hasDebugInfo(const ObjectFile &Obj) {
+  for (const SectionRef &Section : Obj.sections()) {
+    StringRef Name = getSectionName(Section);
+    if ((Name == "debug_info" || Name == "zdebug_info") && Section.getSize())
+      return true;
+  }
+  return false;
+}
+
+std::string locstats::getBuildID(const ObjectFile &Obj) {
+  if (!Obj.isELF())
+    return std::string();
+  for (const SectionRef &Section : Obj.sections()) {
+    if (getSectionName(Section) != "note.gnu.build-id")
+      continue;
+    Expected<StringRef> ContentsOrErr = Section.getContents();
+    if (!ContentsOrErr) {
+      consumeError(ContentsOrErr.takeError());
+      return std::string();
+    }
+    // Walk the notes: namesz, descsz, type, name and desc, both padded to
+    // four bytes.
+    DataExtractor Data(*ContentsOrErr, Obj.isLittleEndian(), 0);
+    uint32_t Offset = 0;
+    while (Data.isValidOffsetForDataOfSize(Offset, 12)) {
+      uint32_t NameSize = Data.getU32(&Offset);
+      uint32_t DescSize = Data.getU32(&Offset);
+      uint32_t Type = Data.getU32(&Offset);
+      uint32_t NameOffset = Offset;
+      uint32_t DescOffset = NameOffset + alignTo(NameSize, 4);
+      if (!Data.isValidOffsetForDataOfSize(DescOffset, DescSize))
+        break;
+      StringRef Name = ContentsOrErr->substr(NameOffset, NameSize);
+      if (Type == ELF::NT_GNU_BUILD_ID && Name == StringRef("GNU\0", 4))
+        return toHex(ContentsOrErr->substr(DescOffset, DescSize),
+                     /*LowerCase=*/true);
+      Offset = DescOffset + alignTo(DescSize, 4);
+    }
+  }
+  return std::string();
+}
+
+/// Extract the file name and the CRC stored in .gnu_debuglink.
+static bool getGNUDebuglinkContents(const ObjectFile &Obj,
+                                    std::string &DebugName,
+                                    uint32_t &CRCHash) {
+  for (const SectionRef &Section : Obj.sections()) {
+    if (getSectionName(Section) != "gnu_debuglink")
+      continue;
+    Expected<StringRef> ContentsOrErr = Section.getContents();
+    if (!ContentsOrErr) {
+      consumeError(ContentsOrErr.takeError());
+      return false;
+    }
+    DataExtractor Data(*ContentsOrErr, Obj.isLittleEndian(), 0);
+    uint32_t Offset = 0;
+    if (const char *DebugNameStr = Data.getCStr(&Offset)) {
+      // 4-byte align the offset.
+      Offset = alignTo(Offset, 4);
+      if (Data.isValidOffsetForDataOfSize(Offset, 4)) {
+        DebugName = DebugNameStr;
+        CRCHash = Data.getU32(&Offset);
+        return true;
+      }
+    }
+    return false;
+  }
+  return false;
+}
+
+static bool checkFileCRC(StringRef Path, uint32_t CRCHash) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB = MemoryBuffer::getFile(Path);
+  if (!MB)
+    return false;
+  return CRCHash == llvm::crc32(0, MB.get()->getBuffer());
+}
+
+/// Return the build-id of the object file at \p Path, or an empty string if
+/// it is not an object file with a build-id.
+static std::string getBuildIDForFile(StringRef Path) {
+  file_magic Magic;
+  if (identify_magic(Path, Magic))
+    return std::string();
+  if (Magic != file_magic::elf_relocatable &&
+      Magic != file_magic::elf_executable &&
+      Magic != file_magic::elf_shared_object)
+    return std::string();
+  Expected<OwningBinary<ObjectFile>> ObjOrErr =
+      ObjectFile::createObjectFile(Path);
+  if (!ObjOrErr) {
+    consumeError(ObjOrErr.takeError());
+    return std::string();
+  }
+  return getBuildID(*ObjOrErr->getBinary());
+}
+
+DebugFileLookup::DebugFileLookup(ArrayRef<std::string> Dirs,
+                                 StringRef IndexPath, bool Rescan)
+    : SearchDirs(Dirs.begin(), Dirs.end()), IndexPath(IndexPath),
+      Rescan(Rescan) {
+  if (SearchDirs.empty())
+    SearchDirs.push_back("/usr/lib/debug");
+  loadIndex();
+}
+
+void DebugFileLookup::loadIndex() {
+  if (IndexPath.empty())
+    return;
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB = MemoryBuffer::getFile(IndexPath);
+  if (!MB)
+    return;
+  SmallVector<StringRef, 0> Lines;
+  MB.get()->getBuffer().split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  if (Lines.empty() ||
+      (Lines.front() != IndexHeader && Lines.front() != IndexHeaderV1))
+    return;
+  for (StringRef Line : makeArrayRef(Lines).drop_front()) {
+    if (Line.consume_front(ScanStampPrefix)) {
+      unsigned long long Stamp;
+      if (!getAsUnsignedInteger(Line, 10, Stamp))
+        ScanStamp = Stamp;
+      continue;
+    }
+    StringRef BuildID, DebugPath;
+    std::tie(BuildID, DebugPath) = Line.split(' ');
+    // Earlier indexes recorded the build-ids a scan did not find as "-".
+    if (BuildID.empty() || DebugPath.empty() || DebugPath == "-")
+      continue;
+    Index[BuildID] = DebugPath;
+  }
+  LLVM_DEBUG(dbgs() << "Loaded " << Index.size()
+                    << " build-id index entries from " << IndexPath << "\n");
+}
+
+Error DebugFileLookup::saveIndex() {
+  if (IndexPath.empty() || !IndexChanged)
+    return Error::success();
+
+  // Write to a temporary file first, so that concurrent runs never see a
+  // partially written index.
+  SmallString<128> TempPath;
+  int FD;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(IndexPath + ".tmp%%%%%%", FD, TempPath))
+    return errorCodeToError(EC);
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << IndexHeader << "\n";
+    if (ScanStamp)
+      OS << ScanStampPrefix << (unsigned long long)ScanStamp << "\n";
+    for (const auto &Entry : Index)
+      OS << Entry.getKey() << " " << Entry.getValue() << "\n";
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, IndexPath)) {
+    sys::fs::remove(TempPath);
+    return errorCodeToError(EC);
+  }
+  IndexChanged = false;
+  return Error::success();
+}
+
+void DebugFileLookup::scanSearchDirs() {
+  TreeScanned = true;
+  for (const std::string &Dir : SearchDirs) {
+    std::error_code EC;
+    for (sys::fs::recursive_directory_iterator I(Dir, EC), E; I != E && !EC;
+         I.increment(EC)) {
+      // The .build-id tree is probed directly by findByBuildID().
+      if (sys::path::filename(I->path()) == ".build-id") {
+        I.no_push();
+        continue;
+      }
+      if (I->type() != sys::fs::file_type::regular_file)
+        continue;
+      std::string BuildID = getBuildIDForFile(I->path());
+      if (BuildID.empty() || Index.count(BuildID))
+        continue;
+      Index[BuildID] = I->path();
+    }
+  }
+  ScanStamp = std::time(nullptr);
+  IndexChanged = true;
+  LLVM_DEBUG(dbgs() << "Indexed " << Index.size() << " debug files\n");
+}
+
+Optional<std::string> DebugFileLookup::findByBuildID(StringRef BuildID) {
+  auto It = Index.find(BuildID);
+  if (It != Index.end()) {
+    if (sys::fs::exists(It->getValue()))
+      return It->getValue();
+    // A stale entry; forget about it.
+    Index.erase(It);
+    IndexChanged = true;
+  }
+
+  if (BuildID.size() < 2)
+    return None;
+  for (const std::string &Dir : SearchDirs) {
+    SmallString<128> DebugPath(Dir);
+    sys::path::append(DebugPath, ".build-id", BuildID.take_front(2),
+                      BuildID.drop_front(2) + ".debug");
+    if (sys::fs::exists(DebugPath))
+      return std::string(DebugPath.str());
+  }
+  return None;
+}
+
+Optional<std::string>
+DebugFileLookup::findByDebuglink(const ObjectFile &Obj, StringRef Path) {
+  std::string DebuglinkName;
+  uint32_t CRCHash;
+  if (!getGNUDebuglinkContents(Obj, DebuglinkName, CRCHash))
+    return None;
+
+  SmallString<128> OrigDir(Path);
+  sys::path::remove_filename(OrigDir);
+  SmallVector<SmallString<128>, 4> Candidates;
+  // Try relative/path/to/original_binary/debuglink_name
+  Candidates.emplace_back(OrigDir);
+  sys::path::append(Candidates.back(), DebuglinkName);
+  // Try relative/path/to/original_binary/.debug/debuglink_name
+  Candidates.emplace_back(OrigDir);
+  sys::path::append(Candidates.back(), ".debug", DebuglinkName);
+  // Try <dir>/absolute/path/to/original_binary/debuglink_name
+  sys::fs::make_absolute(OrigDir);
+  for (const std::string &Dir : SearchDirs) {
+    Candidates.emplace_back(Dir);
+    sys::path::append(Candidates.back(), sys::path::relative_path(OrigDir),
+                      DebuglinkName);
+  }
+
+  for (const auto &Candidate : Candidates)
+    if (checkFileCRC(Candidate, CRCHash))
+      return std::string(Candidate.str());
+  return None;
+}
+
+Optional<std::string> DebugFileLookup::find(const ObjectFile &Obj,
+                                            StringRef Path) {
+  std::string BuildID = getBuildID(Obj);
+  if (!BuildID.empty())
+    if (auto DebugPath = findByBuildID(BuildID))
+      return DebugPath;
+
+  if (auto DebugPath = findByDebuglink(Obj, Path)) {
+    if (!BuildID.empty()) {
+      Index[BuildID] = *DebugPath;
+      IndexChanged = true;
+    }
+    return DebugPath;
+  }
+
+  // As a last resort, index every debug file under the search directories.
+  // This is done at most once per run, and only when the result can be kept.
+  // Once a scan completed the index, it is only repeated on request.
+  if (BuildID.empty() || IndexPath.empty() || TreeScanned ||
+      (ScanStamp && !Rescan))
+    return None;
+  scanSearchDirs();
+  auto It = Index.find(BuildID);
+  if (It != Index.end())
+    return It->getValue();
+  return None;
+}
@@ -0,0 +1,85 @@
+//===-- DebugFileLookup.h - Separate debug file discovery -------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the lookup of separate debug files for stripped
+// binaries, through build-id directories and .gnu_debuglink.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_DEBUGFILELOOKUP_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_DEBUGFILELOOKUP_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Object/ObjectFile.h"
+#include <ctime>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace locstats {
+
+/// Return true if the object file carries its own .debug_info.
+bool hasDebugInfo(const object::ObjectFile &Obj);
+
+/// Return the GNU build-id of the object file as a lowercase hex string, or
+/// an empty string if the object has no NT_GNU_BUILD_ID note.
+std::string getBuildID(const object::ObjectFile &Obj);
+
+/// Locates the separate debug file of a stripped binary.
+///
+/// The lookup tries, in order:
+///   - the persistent build-id index (if one is used),
+///   - <dir>/.build-id/xx/yyyy.debug for each search directory,
+///   - the .gnu_debuglink name next to the binary, in its .debug
+///     subdirectory and under each search directory (with CRC check),
+///   - the index built by a scan of the search directories for the files
+///     with a build-id.
+///
+/// The index is a text file of "<build-id> <path>" lines, so that repeated
+/// runs over many binaries do not walk the whole debug tree again. The
+/// first run that needs it scans the directories, and records the time of
+/// the scan in the index. From then on the index is taken as complete: a
+/// build-id it does not hold has no debug file, until a rescan is asked for.
+class DebugFileLookup {
+public:
+  /// With \p Rescan, the directories are scanned again for a build-id that
+  /// the index does not hold.
+  DebugFileLookup(ArrayRef<std::string> SearchDirs, StringRef IndexPath,
+                  bool Rescan = false);
+
+  /// Return the path to the debug file for \p Obj, which was loaded from
+  /// \p Path, or None if no matching file was found.
+  Optional<std::string> find(const object::ObjectFile &Obj, StringRef Path);
+
+  /// Write the index back to disk if new entries were recorded.
+  Error saveIndex();
+
+private:
+  Optional<std::string> findByBuildID(StringRef BuildID);
+  Optional<std::string> findByDebuglink(const object::ObjectFile &Obj,
+                                        StringRef Path);
+  void loadIndex();
+  void scanSearchDirs();
+
+  std::vector<std::string> SearchDirs;
+  std::string IndexPath;
+  /// Map build-id -> path of the debug file.
+  StringMap<std::string> Index;
+  /// The time of the scan that completed the index, or 0 if there was none.
+  std::time_t ScanStamp = 0;
+  bool Rescan;
+  bool IndexChanged = false;
+  bool TreeScanned = false;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_DEBUGFILELOOKUP_H
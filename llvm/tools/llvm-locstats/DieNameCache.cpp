@@ -0,0 +1,73 @@
+//===-- DieNameCache.cpp - Memoized names of subprograms ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "DieNameCache.h"
+#include "llvm/DebugInfo/DWARF/DWARFFormValue.h"
+
+using namespace llvm;
+using namespace locstats;
+
+/// The bound on the length of the reference chains, in case of malformed,
+/// cyclic references.
+static const unsigned MaxReferenceDepth = 8;
+
+StringRef DieNameCache::getName(DWARFDie Die, DINameKind Kind) {
+  if (Kind == DINameKind::None || !Die.isValid())
+    return StringRef();
+  Names N = resolve(Die, 0);
+  if (Kind == DINameKind::LinkageName && !N.LinkageName.empty())
+    return N.LinkageName;
+  return N.ShortName;
+}
+
+DWARFDie DieNameCache::getReferencedDie(DWARFDie Die, dwarf::Attribute Attr) {
+  Optional<DWARFFormValue> Ref = Die.find(Attr);
+  if (!Ref)
+    return DWARFDie();
+  // A reference within the unit only reads its extracted DIEs.
+  Optional<DWARFFormValue::UnitOffset> Offset = Ref->getAsRelativeReference();
+  if (Offset && Offset->Unit)
+    return Die.getAttributeValueAsReferencedDie(*Ref);
+  std::lock_guard<std::mutex> Lock(ExtractMutex);
+  return Die.getAttributeValueAsReferencedDie(*Ref);
+}
+
+DieNameCache::Names DieNameCache::resolve(DWARFDie Die, unsigned Depth) {
+  Key K(Die.getDwarfUnit(), Die.getOffset());
+  {
+    sys::SmartScopedReader<true> Lock(Mutex);
+    auto It = Cache.find(K);
+    if (It != Cache.end())
+      return It->second;
+  }
+
+  Names N;
+  N.LinkageName = dwarf::toStringRef(
+      Die.find({dwarf::DW_AT_MIPS_linkage_name, dwarf::DW_AT_linkage_name}));
+  N.ShortName = dwarf::toStringRef(Die.find(dwarf::DW_AT_name));
+  // Fill in the missing names from the referenced DIEs, the specification
+  // first, in the order of DWARFDie::findRecursively().
+  if (Depth < MaxReferenceDepth && (N.LinkageName.empty() ||
+                                    N.ShortName.empty())) {
+    for (dwarf::Attribute Attr :
+         {dwarf::DW_AT_specification, dwarf::DW_AT_abstract_origin}) {
+      DWARFDie Origin = getReferencedDie(Die, Attr);
+      if (!Origin)
+        continue;
+      Names OriginNames = resolve(Origin, Depth + 1);
+      if (N.LinkageName.empty())
+        N.LinkageName = OriginNames.LinkageName;
+      if (N.ShortName.empty())
+        N.ShortName = OriginNames.ShortName;
+    }
+  }
+
+  sys::SmartScopedWriter<true> Lock(Mutex);
+  Cache.insert({K, N});
+  return N;
+}
@@ -0,0 +1,68 @@
+//===-- DieNameCache.h - Memoized names of subprograms ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a cache of the names of the DIEs, as resolved through
+// their DW_AT_specification and DW_AT_abstract_origin references.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_DIENAMECACHE_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_DIENAMECACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/DebugInfo/DWARF/DWARFDie.h"
+#include "llvm/DebugInfo/DWARF/DWARFUnit.h"
+#include "llvm/Support/RWMutex.h"
+#include <mutex>
+#include <utility>
+
+namespace llvm {
+namespace locstats {
+
+/// The names of the DIEs of a DWARFContext, shared by the threads.
+///
+/// DWARFDie::getName() walks the specification and abstract origin chain on
+/// every call, and the references to other units go through a binary search
+/// of the units. Here the names of each DIE are resolved once, from the
+/// names of the DIE it refers to, so that the thousands of inlined instances
+/// of a function share the walk to their abstract origin. The names point
+/// into the string sections, which outlive the cache, so they are not
+/// copied.
+class DieNameCache {
+public:
+  /// Return the name of \p Die, like DWARFDie::getName(), or an empty
+  /// string.
+  StringRef getName(DWARFDie Die, DINameKind Kind);
+
+  /// Return the DIE that the \p Attr reference of \p Die points to. Only
+  /// the units being traversed are extracted before the threads start, so
+  /// a reference to another unit may extract it. That is done by one
+  /// thread at a time.
+  DWARFDie getReferencedDie(DWARFDie Die, dwarf::Attribute Attr);
+
+private:
+  struct Names {
+    StringRef LinkageName;
+    StringRef ShortName;
+  };
+
+  Names resolve(DWARFDie Die, unsigned Depth);
+
+  /// The DIEs are keyed by unit and offset, as the units of the split DWARF
+  /// files may share offsets with those of the main file.
+  using Key = std::pair<const DWARFUnit *, uint64_t>;
+  sys::SmartRWMutex<true> Mutex;
+  DenseMap<Key, Names> Cache;
+  std::mutex ExtractMutex;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_DIENAMECACHE_H
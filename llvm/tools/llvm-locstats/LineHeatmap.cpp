@@ -0,0 +1,70 @@
+//===-- LineHeatmap.cpp - Per source line variable availability -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LineHeatmap.h"
+#include <algorithm>
+
+using namespace llvm;
+using namespace locstats;
+
+void LineHeatmap::endFunction(size_t Mark, ArrayRef<DWARFAddressRange> Ranges,
+                              const CompactLineTable &LineTable) {
+  // Sample each row at its first address within the function.
+  Samples.clear();
+  for (const DWARFAddressRange &Range : Ranges)
+    LineTable.forEachRow(Range.LowPC, Range.HighPC, Range.SectionIndex,
+                         [&](uint64_t Address, uint32_t File, uint32_t Line,
+                             uint32_t) {
+                           if (Line)
+                             Samples.push_back({Address, File, Line});
+                         });
+  std::sort(Samples.begin(), Samples.end());
+
+  auto EventsBegin = Events.begin() + Mark;
+  std::sort(EventsBegin, Events.end(), [](const Event &LHS, const Event &RHS) {
+    return LHS.Address < RHS.Address;
+  });
+
+  // Sweep the rows and the events together.
+  int64_t InScope = 0;
+  int64_t Available = 0;
+  auto E = EventsBegin;
+  for (const auto &Sample : Samples) {
+    for (; E != Events.end() && E->Address <= Sample.Address; ++E) {
+      InScope += E->InScope;
+      Available += E->Available;
+    }
+    LineAvailability &Line = Lines[{Sample.File, Sample.Line}];
+    Line.InScope += InScope;
+    // The locations are clipped to the scope of their variable, but the
+    // overlapping entries of a malformed location list count it twice.
+    Line.Available += std::min(Available, InScope);
+  }
+  Events.erase(EventsBegin, Events.end());
+}
+
+void LineHeatmap::resolveFiles(const CompactLineTable &LineTable) {
+  for (const auto &Line : Lines) {
+    LineAvailability &Total =
+        Files[LineTable.getFileName(Line.first.first)][Line.first.second];
+    Total.InScope += Line.second.InScope;
+    Total.Available += Line.second.Available;
+  }
+  Lines.clear();
+}
+
+void LineHeatmap::merge(const LineHeatmap &Other) {
+  for (const auto &File : Other.Files) {
+    FileLines &Lines = Files[File.first];
+    for (const auto &Line : File.second) {
+      LineAvailability &Total = Lines[Line.first];
+      Total.InScope += Line.second.InScope;
+      Total.Available += Line.second.Available;
+    }
+  }
+}
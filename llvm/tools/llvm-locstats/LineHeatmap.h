@@ -0,0 +1,106 @@
+//===-- LineHeatmap.h - Per source line variable availability ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the join of the variable location ranges with the line
+// table, which tells how many of the variables in scope at the addresses of
+// a source line have a location there.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_LINEHEATMAP_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_LINEHEATMAP_H
+
+#include "CompactLineTable.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/DebugInfo/DWARF/DWARFAddressRange.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace locstats {
+
+/// The number of variables in scope and with a location, summed over the
+/// line table rows of a source line.
+struct LineAvailability {
+  uint64_t InScope = 0;
+  uint64_t Available = 0;
+};
+
+/// The per source line availability of the variables of a binary.
+///
+/// The ranges where the variables of a function are in scope and have a
+/// location are recorded as events. When the function is done, they are
+/// sorted and swept along with the line table rows within the function, so
+/// the join costs O((rows + entries) log (rows + entries)) per function
+/// rather than rows times variables.
+class LineHeatmap {
+public:
+  using FileLines = std::map<uint32_t, LineAvailability>;
+
+  /// Record that a variable is in scope within [LowPC, HighPC).
+  void addScope(uint64_t LowPC, uint64_t HighPC) {
+    if (LowPC < HighPC) {
+      Events.push_back({LowPC, 1, 0});
+      Events.push_back({HighPC, -1, 0});
+    }
+  }
+
+  /// Record that a variable has a location within [LowPC, HighPC), which
+  /// must lie within one of its addScope() ranges.
+  void addLocation(uint64_t LowPC, uint64_t HighPC) {
+    if (LowPC < HighPC) {
+      Events.push_back({LowPC, 0, 1});
+      Events.push_back({HighPC, 0, -1});
+    }
+  }
+
+  /// Return the mark to pass to endFunction() for a function starting now.
+  size_t beginFunction() const { return Events.size(); }
+
+  /// Join the events recorded since \p Mark with the rows of \p LineTable
+  /// within the function's \p Ranges, then drop them.
+  void endFunction(size_t Mark, ArrayRef<DWARFAddressRange> Ranges,
+                   const CompactLineTable &LineTable);
+
+  /// Attribute the lines joined so far to the files of \p LineTable, the
+  /// line table of the unit being traversed.
+  void resolveFiles(const CompactLineTable &LineTable);
+
+  void merge(const LineHeatmap &Other);
+
+  const std::map<std::string, FileLines> &files() const { return Files; }
+
+private:
+  struct Event {
+    uint64_t Address;
+    int32_t InScope;
+    int32_t Available;
+  };
+  std::vector<Event> Events;
+  struct Sample {
+    uint64_t Address;
+    uint32_t File;
+    uint32_t Line;
+    bool operator<(const Sample &Other) const {
+      return Address < Other.Address;
+    }
+  };
+  /// The rows of the function being joined. Kept to reuse the storage
+  /// across functions.
+  std::vector<Sample> Samples;
+  /// The availability by (file index, line) in the current unit.
+  DenseMap<std::pair<uint32_t, uint32_t>, LineAvailability> Lines;
+  std::map<std::string, FileLines> Files;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_LINEHEATMAP_H
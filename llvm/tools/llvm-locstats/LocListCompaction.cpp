@@ -0,0 +1,169 @@
+//===-- LocListCompaction.cpp - Location list compaction report -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LocListCompaction.h"
+#include "llvm/ADT/Hashing.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/LEB128.h"
+#include <algorithm>
+#include <vector>
+
+using namespace llvm;
+using namespace locstats;
+
+void LocCompactionStats::merge(const LocCompactionStats &Other) {
+  Lists += Other.Lists;
+  Entries += Other.Entries;
+  Bytes += Other.Bytes;
+  MergeableEntries += Other.MergeableEntries;
+  MergeableBytes += Other.MergeableBytes;
+  EmptyEntries += Other.EmptyEntries;
+  EmptyBytes += Other.EmptyBytes;
+  DuplicateLists += Other.DuplicateLists;
+  DuplicateBytes += Other.DuplicateBytes;
+  V5Bytes += Other.V5Bytes;
+}
+
+json::Value LocCompactionStats::toJSON() const {
+  return json::Object{{"lists", (int64_t)Lists},
+                      {"entries", (int64_t)Entries},
+                      {"bytes", (int64_t)Bytes},
+                      {"mergeable_entries", (int64_t)MergeableEntries},
+                      {"mergeable_bytes", (int64_t)MergeableBytes},
+                      {"empty_entries", (int64_t)EmptyEntries},
+                      {"empty_bytes", (int64_t)EmptyBytes},
+                      {"duplicate_lists", (int64_t)DuplicateLists},
+                      {"duplicate_bytes", (int64_t)DuplicateBytes},
+                      {"v5_bytes", (int64_t)V5Bytes}};
+}
+
+bool LocCompactionStats::fromJSON(const json::Value &V) {
+  const json::Object *O = V.getAsObject();
+  if (!O)
+    return false;
+  Lists += O->getInteger("lists").getValueOr(0);
+  Entries += O->getInteger("entries").getValueOr(0);
+  Bytes += O->getInteger("bytes").getValueOr(0);
+  MergeableEntries += O->getInteger("mergeable_entries").getValueOr(0);
+  MergeableBytes += O->getInteger("mergeable_bytes").getValueOr(0);
+  EmptyEntries += O->getInteger("empty_entries").getValueOr(0);
+  EmptyBytes += O->getInteger("empty_bytes").getValueOr(0);
+  DuplicateLists += O->getInteger("duplicate_lists").getValueOr(0);
+  DuplicateBytes += O->getInteger("duplicate_bytes").getValueOr(0);
+  V5Bytes += O->getInteger("v5_bytes").getValueOr(0);
+  return true;
+}
+
+/// Return the size of a DW_LLE_offset_pair entry.
+static uint64_t getOffsetPairSize(uint64_t Begin, uint64_t End,
+                                  StringRef Expr) {
+  return 1 + getULEB128Size(Begin) + getULEB128Size(End) +
+         getULEB128Size(Expr.size()) + Expr.size();
+}
+
+/// Return the size of the DWARF v5 entries of a run of entries sharing a
+/// base address. A DW_LLE_base_address entry is needed if the base was
+/// selected in .debug_loc, and pays off on its own if the offsets from the
+/// unit base are large, e.g. when the unit has no DW_AT_low_pc.
+static uint64_t getV5RunSize(ArrayRef<RawLocEntry> Run, bool SelectedBase,
+                             uint8_t AddressSize) {
+  if (Run.empty())
+    return SelectedBase ? 1 + AddressSize : 0;
+  uint64_t Min = UINT64_MAX;
+  for (const RawLocEntry &Entry : Run)
+    Min = std::min(Min, Entry.Begin);
+  uint64_t AsIs = 0;
+  uint64_t Rebased = 1 + AddressSize;
+  for (const RawLocEntry &Entry : Run) {
+    uint64_t End = std::max(Entry.Begin, Entry.End);
+    AsIs += getOffsetPairSize(Entry.Begin, End, Entry.Expr);
+    Rebased += getOffsetPairSize(Entry.Begin - Min, End - Min, Entry.Expr);
+  }
+  return SelectedBase ? Rebased : std::min(AsIs, Rebased);
+}
+
+void LocListCompaction::addList(uint64_t Offset, ArrayRef<RawLocEntry> Entries,
+                                uint64_t BaseAddr, uint8_t AddressSize) {
+  ListSummary Summary = {};
+  hash_code Hash(0);
+  // The end of list entry.
+  Summary.Bytes = 2 * AddressSize;
+  Summary.V5Bytes = 1;
+
+  // The last entry kept, for the merge of the next one into it.
+  uint64_t PrevEnd = 0;
+  StringRef PrevExpr;
+  bool HasPrev = false;
+  size_t RunStart = 0;
+  bool SelectedBase = false;
+  for (size_t I = 0; I < Entries.size(); ++I) {
+    const RawLocEntry &Entry = Entries[I];
+    if (Entry.IsBaseAddress) {
+      Summary.Bytes += 2 * AddressSize;
+      Summary.V5Bytes += getV5RunSize(Entries.slice(RunStart, I - RunStart),
+                                      SelectedBase, AddressSize);
+      RunStart = I + 1;
+      SelectedBase = true;
+      BaseAddr = Entry.End;
+      continue;
+    }
+    uint32_t EntryBytes = 2 * AddressSize + 2 + Entry.Expr.size();
+    uint64_t Begin = BaseAddr + Entry.Begin;
+    uint64_t End = BaseAddr + Entry.End;
+    Hash = hash_combine(Hash, Begin, End, Entry.Expr);
+    ++Summary.Entries;
+    Summary.Bytes += EntryBytes;
+    if (Begin >= End) {
+      ++Summary.EmptyEntries;
+      Summary.EmptyBytes += EntryBytes;
+      continue;
+    }
+    if (HasPrev && PrevEnd == Begin && PrevExpr == Entry.Expr) {
+      ++Summary.MergeableEntries;
+      Summary.MergeableBytes += EntryBytes;
+    }
+    PrevEnd = End;
+    PrevExpr = Entry.Expr;
+    HasPrev = true;
+  }
+  Summary.V5Bytes += getV5RunSize(Entries.drop_front(RunStart), SelectedBase,
+                                  AddressSize);
+  Summary.Hash = Hash;
+  Lists.insert({Offset, Summary});
+}
+
+void LocListCompaction::merge(const LocListCompaction &Other) {
+  for (const auto &List : Other.Lists)
+    Lists.insert(List);
+}
+
+LocCompactionStats LocListCompaction::summarize() const {
+  LocCompactionStats Stats;
+  std::vector<std::pair<uint64_t, uint32_t>> Hashes;
+  Hashes.reserve(Lists.size());
+  for (const auto &List : Lists) {
+    const ListSummary &Summary = List.second;
+    ++Stats.Lists;
+    Stats.Entries += Summary.Entries;
+    Stats.Bytes += Summary.Bytes;
+    Stats.MergeableEntries += Summary.MergeableEntries;
+    Stats.MergeableBytes += Summary.MergeableBytes;
+    Stats.EmptyEntries += Summary.EmptyEntries;
+    Stats.EmptyBytes += Summary.EmptyBytes;
+    Stats.V5Bytes += Summary.V5Bytes;
+    Hashes.push_back({Summary.Hash, Summary.Bytes});
+  }
+  // All the lists with the same entries but one could refer to it instead.
+  llvm::sort(Hashes);
+  for (size_t I = 1; I < Hashes.size(); ++I)
+    if (Hashes[I].first == Hashes[I - 1].first) {
+      ++Stats.DuplicateLists;
+      Stats.DuplicateBytes += Hashes[I].second;
+    }
+  return Stats;
+}
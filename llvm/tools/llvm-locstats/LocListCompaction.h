@@ -0,0 +1,104 @@
+//===-- LocListCompaction.h - Location list compaction report ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the analysis of the .debug_loc lists decoded during the
+// traversal, which estimates how many bytes merging their entries, dropping
+// the empty ones, sharing the identical lists and re-encoding them as DWARF v5
+// .debug_loclists would save.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_LOCLISTCOMPACTION_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_LOCLISTCOMPACTION_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/JSON.h"
+#include <cstdint>
+
+namespace llvm {
+namespace locstats {
+
+/// A .debug_loc entry as encoded: its addresses are relative to the current
+/// base address, or a base address selection entry sets the new base in End.
+struct RawLocEntry {
+  uint64_t Begin;
+  uint64_t End;
+  StringRef Expr;
+  bool IsBaseAddress;
+};
+
+/// The compaction opportunities of a set of location lists. All the sizes
+/// are in bytes of .debug_loc, except V5Bytes.
+struct LocCompactionStats {
+  uint64_t Lists = 0;
+  uint64_t Entries = 0;
+  uint64_t Bytes = 0;
+  /// Entries starting where the previous one ends, with the same expression.
+  uint64_t MergeableEntries = 0;
+  uint64_t MergeableBytes = 0;
+  /// Entries whose range is empty.
+  uint64_t EmptyEntries = 0;
+  uint64_t EmptyBytes = 0;
+  /// Lists identical to another list of the same unit, which could share it.
+  uint64_t DuplicateLists = 0;
+  uint64_t DuplicateBytes = 0;
+  /// The size of the lists re-encoded as DW_LLE_base_address and
+  /// DW_LLE_offset_pair entries, as they are.
+  uint64_t V5Bytes = 0;
+
+  void merge(const LocCompactionStats &Other);
+
+  json::Value toJSON() const;
+  /// Add the counts of toJSON() output. Returns false on malformed input.
+  bool fromJSON(const json::Value &V);
+};
+
+/// The location lists of one unit, analyzed as the traversal decodes them.
+///
+/// Each list is summarized once, however many variables refer to it, and
+/// only its summary and a hash of its entries are kept. The identical lists
+/// are found by their hashes once the whole unit is done, so the parts of a
+/// split unit are merged before summarize() is called.
+class LocListCompaction {
+public:
+  /// Return true if the list at \p Offset was already analyzed.
+  bool contains(uint64_t Offset) const { return Lists.count(Offset); }
+
+  /// Analyze the list at \p Offset, made of \p Entries in .debug_loc order.
+  /// \p BaseAddr is the base address of the unit.
+  void addList(uint64_t Offset, ArrayRef<RawLocEntry> Entries,
+               uint64_t BaseAddr, uint8_t AddressSize);
+
+  void merge(const LocListCompaction &Other);
+
+  /// Return the opportunities of all the lists, duplicates included.
+  LocCompactionStats summarize() const;
+
+  bool empty() const { return Lists.empty(); }
+
+private:
+  struct ListSummary {
+    /// The hash of the entries, with their absolute addresses.
+    uint64_t Hash;
+    uint32_t Entries;
+    uint32_t Bytes;
+    uint32_t MergeableEntries;
+    uint32_t MergeableBytes;
+    uint32_t EmptyEntries;
+    uint32_t EmptyBytes;
+    uint32_t V5Bytes;
+  };
+  DenseMap<uint64_t, ListSummary> Lists;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_LOCLISTCOMPACTION_H
@@ -0,0 +1,36 @@
+//===-- LocStats.h - Debug location coverage utility ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the entry points of llvm-locstats, shared by the tool
+// and its fuzzer.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_LOCSTATS_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_LOCSTATS_H
+
+#include "llvm/ADT/Twine.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace llvm {
+namespace locstats {
+
+/// Collect the location statistics of \p Obj and print them to \p OS, as
+/// the command line options ask.
+void collectLocstats(object::ObjectFile &Obj, DWARFContext &DICtx,
+                     Twine Filename, raw_ostream &OS);
+
+/// Run the tool on the given command line.
+int runLocStats(int argc, char **argv);
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_LOCSTATS_H
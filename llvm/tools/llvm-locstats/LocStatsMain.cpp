@@ -0,0 +1,22 @@
+//===-- LocStatsMain.cpp - Debug location coverage utility for llvm -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The entry point of llvm-locstats. The fuzzer links the rest of the tool
+// with its own entry point instead.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LocStats.h"
+#include "llvm/Support/InitLLVM.h"
+
+using namespace llvm;
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  return locstats::runLocStats(argc, argv);
+}
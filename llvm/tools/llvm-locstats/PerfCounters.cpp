@@ -0,0 +1,176 @@
+//===-- PerfCounters.cpp - Hardware performance counters ------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "PerfCounters.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Format.h"
+#include <atomic>
+#include <vector>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+using namespace locstats;
+
+PhaseCounters *locstats::PhaseCountersInstance = nullptr;
+
+PerfCounts &PerfCounts::operator+=(const PerfCounts &Other) {
+  for (unsigned I = 0; I < NumPerfCounters; ++I)
+    Values[I] += Other.Values[I];
+  Valid &= Other.Valid;
+  return *this;
+}
+
+PerfCounts PerfCounts::operator-(const PerfCounts &Start) const {
+  PerfCounts Delta;
+  for (unsigned I = 0; I < NumPerfCounters; ++I)
+    Delta.Values[I] = Values[I] - Start.Values[I];
+  Delta.Valid = Valid & Start.Valid;
+  return Delta;
+}
+
+static std::atomic<bool> PerfCountersEnabled(false);
+
+#ifdef __linux__
+/// The counters of the calling thread; -1 for the ones that are unavailable.
+static LLVM_THREAD_LOCAL int ThreadFDs[NumPerfCounters];
+static LLVM_THREAD_LOCAL bool ThreadOpened = false;
+
+/// Every descriptor opened by any thread, to be closed at the end.
+static std::mutex OpenFDsMutex;
+static std::vector<int> OpenFDs;
+
+/// Open the counters of the calling thread. Return the number opened.
+static unsigned openThreadCounters(std::string *Reason) {
+  static const std::pair<uint32_t, uint64_t> Events[NumPerfCounters] = {
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+      {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+  ThreadOpened = true;
+  unsigned NumOpened = 0;
+  for (unsigned I = 0; I < NumPerfCounters; ++I) {
+    perf_event_attr Attr;
+    memset(&Attr, 0, sizeof(Attr));
+    Attr.size = sizeof(Attr);
+    Attr.type = Events[I].first;
+    Attr.config = Events[I].second;
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv = 1;
+    // The counters are not grouped, so that each one that the machine does
+    // not have is left out on its own.
+    int FD = syscall(__NR_perf_event_open, &Attr, /*pid=*/0, /*cpu=*/-1,
+                     /*group_fd=*/-1, /*flags=*/0);
+    ThreadFDs[I] = FD;
+    if (FD < 0) {
+      if (Reason && Reason->empty())
+        *Reason = strerror(errno);
+      continue;
+    }
+    ++NumOpened;
+    std::lock_guard<std::mutex> Lock(OpenFDsMutex);
+    OpenFDs.push_back(FD);
+  }
+  return NumOpened;
+}
+
+bool locstats::enablePerfCounters(std::string &Reason) {
+  if (!openThreadCounters(&Reason))
+    return false;
+  PerfCountersEnabled = true;
+  return true;
+}
+
+void locstats::disablePerfCounters() {
+  PerfCountersEnabled = false;
+  std::lock_guard<std::mutex> Lock(OpenFDsMutex);
+  for (int FD : OpenFDs)
+    close(FD);
+  OpenFDs.clear();
+}
+
+PerfCounts locstats::readPerfCounters() {
+  PerfCounts Counts;
+  if (!PerfCountersEnabled)
+    return Counts;
+  if (!ThreadOpened)
+    openThreadCounters(nullptr);
+  for (unsigned I = 0; I < NumPerfCounters; ++I) {
+    uint64_t Value;
+    if (ThreadFDs[I] < 0 ||
+        read(ThreadFDs[I], &Value, sizeof(Value)) != sizeof(Value))
+      continue;
+    Counts.Values[I] = Value;
+    Counts.Valid |= 1u << I;
+  }
+  return Counts;
+}
+#else
+bool locstats::enablePerfCounters(std::string &Reason) {
+  Reason = "only supported on Linux";
+  return false;
+}
+
+void locstats::disablePerfCounters() {}
+
+PerfCounts locstats::readPerfCounters() { return PerfCounts(); }
+#endif
+
+void PhaseCounters::add(Phase P, std::chrono::nanoseconds Time,
+                        const PerfCounts &Counts) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Totals &T = ByPhase[(unsigned)P];
+  if (!T.Samples++)
+    T.Counts.Valid = Counts.Valid;
+  T.Time += Time;
+  T.Counts += Counts;
+}
+
+void PhaseCounters::print(raw_ostream &OS) {
+  static const char *const Names[] = {"", "load", "extract", "traverse",
+                                      "report"};
+  std::lock_guard<std::mutex> Lock(Mutex);
+  OS << "    phase         ms        cycles  instructions   IPC"
+        "  cache misses  branch misses\n";
+  OS << "-------------------------------------------------\n";
+  auto PrintCount = [&](const PerfCounts &Counts, PerfCounterKind Kind,
+                        unsigned Width) {
+    if (Counts.Valid & (1u << Kind))
+      OS << format_decimal(Counts.Values[Kind], Width);
+    else
+      OS << right_justify("n/a", Width);
+  };
+  for (unsigned P = 1; P < (unsigned)Phase::NumPhases; ++P) {
+    const Totals &T = ByPhase[P];
+    if (!T.Samples)
+      continue;
+    OS << "    " << left_justify(Names[P], 9)
+       << format("%7.0f", T.Time.count() / 1e6) << "  ";
+    PrintCount(T.Counts, Cycles, 12);
+    OS << "  ";
+    PrintCount(T.Counts, Instructions, 12);
+    const unsigned IPCMask = (1u << Cycles) | (1u << Instructions);
+    if ((T.Counts.Valid & IPCMask) == IPCMask && T.Counts.Values[Cycles])
+      OS << format("%6.2f", (double)T.Counts.Values[Instructions] /
+                                T.Counts.Values[Cycles]);
+    else
+      OS << "   n/a";
+    OS << "  ";
+    PrintCount(T.Counts, CacheMisses, 12);
+    OS << "  ";
+    PrintCount(T.Counts, BranchMisses, 13);
+    OS << "\n";
+  }
+  OS << "=================================================\n";
+}
@@ -0,0 +1,84 @@
+//===-- PerfCounters.h - Hardware performance counters ----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares the per-thread hardware performance counters and their
+// totals by phase of the tool.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_PERFCOUNTERS_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_PERFCOUNTERS_H
+
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace llvm {
+namespace locstats {
+
+/// The hardware events counted by -perf-counters.
+enum PerfCounterKind {
+  Cycles,
+  Instructions,
+  CacheMisses,
+  BranchMisses,
+  NumPerfCounters
+};
+
+/// Counts of hardware events, with a bit in Valid for each counter that
+/// could be read.
+struct PerfCounts {
+  uint64_t Values[NumPerfCounters] = {};
+  unsigned Valid = 0;
+
+  PerfCounts &operator+=(const PerfCounts &Other);
+  PerfCounts operator-(const PerfCounts &Start) const;
+};
+
+/// Start counting the hardware events of every thread that reads them. This
+/// is only supported on Linux, through perf_event_open, which may also be
+/// denied, as it often is within containers. Return false, with the reason in
+/// \p Reason, if no counter can be opened on the calling thread.
+bool enablePerfCounters(std::string &Reason);
+
+/// Close the counters of all the threads.
+void disablePerfCounters();
+
+/// Read the counters of the calling thread, opening them on first use.
+PerfCounts readPerfCounters();
+
+/// The phases of the tool measured by -perf-counters.
+enum class Phase { None, Load, Extract, Traverse, Report, NumPhases };
+
+/// Accumulates the time and the hardware events spent in each phase, from
+/// any thread.
+class PhaseCounters {
+public:
+  void add(Phase P, std::chrono::nanoseconds Time, const PerfCounts &Counts);
+  void print(raw_ostream &OS);
+
+private:
+  struct Totals {
+    std::chrono::nanoseconds Time{0};
+    PerfCounts Counts;
+    unsigned Samples = 0;
+  };
+
+  std::mutex Mutex;
+  Totals ByPhase[(unsigned)Phase::NumPhases];
+};
+
+/// The phase totals being collected, if any.
+extern PhaseCounters *PhaseCountersInstance;
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_PERFCOUNTERS_H
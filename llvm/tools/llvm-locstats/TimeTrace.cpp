@@ -0,0 +1,114 @@
+//===-- TimeTrace.cpp - Multi-threaded time trace recorder ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "TimeTrace.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/JSON.h"
+
+using namespace llvm;
+using namespace locstats;
+
+TimeTrace *locstats::TimeTraceInstance = nullptr;
+
+/// The event buffer of the calling thread, and the trace that owns it.
+static LLVM_THREAD_LOCAL void *CurrentThreadEvents = nullptr;
+static LLVM_THREAD_LOCAL const TimeTrace *CurrentTrace = nullptr;
+
+TimeTrace::TimeTrace(unsigned GranularityUs)
+    : Begin(Clock::now()), Granularity(GranularityUs) {
+  // The thread that starts the trace gets the first track.
+  getThreadEvents();
+}
+
+TimeTrace::~TimeTrace() = default;
+
+TimeTrace::ThreadEvents &TimeTrace::getThreadEvents() {
+  if (CurrentTrace != this) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Threads.push_back(llvm::make_unique<ThreadEvents>());
+    Threads.back()->Tid = Threads.size() - 1;
+    CurrentThreadEvents = Threads.back().get();
+    CurrentTrace = this;
+  }
+  return *static_cast<ThreadEvents *>(CurrentThreadEvents);
+}
+
+void TimeTrace::record(StringRef Name, std::string Detail,
+                       Clock::time_point Start, uint64_t UnitOffset,
+                       uint64_t UnitSize, const PerfCounts &Counts) {
+  using namespace std::chrono;
+  auto Duration = duration_cast<microseconds>(Clock::now() - Start);
+  if (Duration < Granularity)
+    return;
+  getThreadEvents().Events.push_back(
+      {Name, std::move(Detail),
+       duration_cast<microseconds>(Start - Begin).count(), Duration.count(),
+       UnitOffset, UnitSize, Counts});
+}
+
+void TimeTraceScope::finish() {
+  TimeTrace::Clock::time_point End = TimeTrace::Clock::now();
+  PerfCounts Counts;
+  if (Counted) {
+    Counts = readPerfCounters() - StartCounts;
+    PhaseCountersInstance->add(P, End - Start, Counts);
+  }
+  if (TimeTraceInstance)
+    TimeTraceInstance->record(Name, std::move(Detail), Start, UnitOffset,
+                              UnitSize, Counts);
+}
+
+void TimeTrace::write(raw_ostream &OS) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  const int Pid = 1;
+  json::OStream J(OS);
+  J.object([&] {
+    J.attributeArray("traceEvents", [&] {
+      for (const auto &Thread : Threads) {
+        for (const Event &E : Thread->Events) {
+          J.object([&] {
+            J.attribute("pid", Pid);
+            J.attribute("tid", Thread->Tid);
+            J.attribute("ph", "X");
+            J.attribute("ts", E.StartUs);
+            J.attribute("dur", E.DurationUs);
+            J.attribute("name", E.Name);
+            J.attributeObject("args", [&] {
+              if (!E.Detail.empty())
+                J.attribute("detail", E.Detail);
+              if (E.UnitSize) {
+                J.attribute("unit_offset", (int64_t)E.UnitOffset);
+                J.attribute("unit_size", (int64_t)E.UnitSize);
+              }
+              static const char *const CounterNames[] = {
+                  "cycles", "instructions", "cache_misses", "branch_misses"};
+              for (unsigned I = 0; I < NumPerfCounters; ++I)
+                if (E.Counts.Valid & (1u << I))
+                  J.attribute(CounterNames[I], (int64_t)E.Counts.Values[I]);
+            });
+          });
+        }
+        // Name the tracks, the first one being the main thread's.
+        J.object([&] {
+          J.attribute("pid", Pid);
+          J.attribute("tid", Thread->Tid);
+          J.attribute("ph", "M");
+          J.attribute("name", "thread_name");
+          J.attributeObject("args", [&] {
+            J.attribute("name", Thread->Tid
+                                    ? "worker " + std::to_string(Thread->Tid)
+                                    : std::string("main"));
+          });
+        });
+      }
+    });
+    J.attribute("displayTimeUnit", "ms");
+  });
+  OS << "\n";
+}
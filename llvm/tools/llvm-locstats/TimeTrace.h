@@ -0,0 +1,128 @@
+//===-- TimeTrace.h - Multi-threaded time trace recorder --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a recorder of timed events from several threads, written
+// out in the Chrome trace event format, and the scopes that measure both the
+// events and the phases of the tool.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TOOLS_LLVM_LOCSTATS_TIMETRACE_H
+#define LLVM_TOOLS_LLVM_LOCSTATS_TIMETRACE_H
+
+#include "PerfCounters.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace llvm {
+namespace locstats {
+
+/// Records the timed events of any number of threads.
+///
+/// Unlike llvm/Support/TimeProfiler.h, which keeps a single stack of events,
+/// every thread appends to its own buffer without taking a lock. The buffers
+/// are joined when the trace is written, with one track per thread, so that
+/// chrome://tracing shows how the units were scheduled on the workers.
+class TimeTrace {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /// Events shorter than \p GranularityUs microseconds are dropped.
+  explicit TimeTrace(unsigned GranularityUs);
+  ~TimeTrace();
+
+  /// Record the event \p Name of the calling thread, which started at
+  /// \p Start. \p UnitOffset and \p UnitSize describe the unit it is about,
+  /// if \p UnitSize is not zero, and \p Counts the hardware events counted
+  /// during the event, if any.
+  void record(StringRef Name, std::string Detail, Clock::time_point Start,
+              uint64_t UnitOffset, uint64_t UnitSize,
+              const PerfCounts &Counts);
+
+  /// Write the events as a JSON trace for chrome://tracing.
+  void write(raw_ostream &OS);
+
+private:
+  struct Event {
+    StringRef Name;
+    std::string Detail;
+    int64_t StartUs;
+    int64_t DurationUs;
+    uint64_t UnitOffset;
+    uint64_t UnitSize;
+    PerfCounts Counts;
+  };
+  struct ThreadEvents {
+    unsigned Tid;
+    std::vector<Event> Events;
+  };
+
+  ThreadEvents &getThreadEvents();
+
+  const Clock::time_point Begin;
+  const std::chrono::microseconds Granularity;
+  std::mutex Mutex;
+  std::vector<std::unique_ptr<ThreadEvents>> Threads;
+};
+
+/// The trace being recorded, if any.
+extern TimeTrace *TimeTraceInstance;
+
+/// Records the lifetime of the scope as an event and, if it belongs to a
+/// phase, adds its time and hardware events to the phase totals. When
+/// neither is collected, the cost is a couple of branches.
+class TimeTraceScope {
+public:
+  TimeTraceScope(StringRef Name, StringRef Detail = StringRef(),
+                 Phase P = Phase::None)
+      : TimeTraceScope(Name, Detail, 0, 0, P) {}
+  TimeTraceScope(StringRef Name, uint64_t UnitOffset, uint64_t UnitSize,
+                 Phase P = Phase::None)
+      : TimeTraceScope(Name, StringRef(), UnitOffset, UnitSize, P) {}
+  TimeTraceScope(const TimeTraceScope &) = delete;
+  TimeTraceScope &operator=(const TimeTraceScope &) = delete;
+
+  ~TimeTraceScope() {
+    if (TimeTraceInstance || Counted)
+      finish();
+  }
+
+private:
+  TimeTraceScope(StringRef Name, StringRef Detail, uint64_t UnitOffset,
+                 uint64_t UnitSize, Phase P)
+      : Name(Name), UnitOffset(UnitOffset), UnitSize(UnitSize), P(P),
+        Counted(PhaseCountersInstance && P != Phase::None) {
+    if (TimeTraceInstance || Counted) {
+      this->Detail = Detail;
+      if (Counted)
+        StartCounts = readPerfCounters();
+      Start = TimeTrace::Clock::now();
+    }
+  }
+
+  void finish();
+
+  StringRef Name;
+  std::string Detail;
+  uint64_t UnitOffset;
+  uint64_t UnitSize;
+  Phase P;
+  bool Counted;
+  PerfCounts StartCounts;
+  TimeTrace::Clock::time_point Start;
+};
+
+} // end namespace locstats
+} // end namespace llvm
+
+#endif // LLVM_TOOLS_LLVM_LOCSTATS_TIMETRACE_H
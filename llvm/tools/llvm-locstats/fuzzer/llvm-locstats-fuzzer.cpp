@@ -0,0 +1,74 @@
+//===-- llvm-locstats-fuzzer.cpp - Fuzz the llvm-locstats tool ------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file implements a function that runs the llvm-locstats pipeline on a
+/// single input, and crashes if it takes more than linear time in the size
+/// of the input. This function is then linked into the Fuzzer library.
+///
+//===----------------------------------------------------------------------===//
+
+#include "../LocStats.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+#include <chrono>
+#include <cstdlib>
+
+using namespace llvm;
+using namespace object;
+
+/// The time an input may take: a fixed allowance, plus one that is linear in
+/// its size. Deep nesting, long sibling lists, cyclic references or
+/// overlapping location lists that make the pipeline super-linear show up as
+/// inputs exceeding it. The allowance is generous enough for sanitized
+/// builds, and the fuzzer's own -timeout still catches the hangs.
+static const std::chrono::milliseconds BaseBudget(200);
+static const std::chrono::microseconds BudgetPerByte(50);
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  // Also go through the optional reports. -cfi-aware is left out, as the
+  // call frame parser is fuzzed by llvm-dwarfdump-fuzzer.
+  const char *Args[] = {"llvm-locstats-fuzzer", "-call-sites",
+                        "-distribution", "-globals", "-inline-depth"};
+  cl::ParseCommandLineOptions(array_lengthof(Args), Args);
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(uint8_t *data, size_t size) {
+  std::unique_ptr<MemoryBuffer> Buff = MemoryBuffer::getMemBuffer(
+      StringRef((const char *)data, size), "", false);
+
+  Expected<std::unique_ptr<ObjectFile>> ObjOrErr =
+      ObjectFile::createObjectFile(Buff->getMemBufferRef());
+  if (auto E = ObjOrErr.takeError()) {
+    consumeError(std::move(E));
+    return 0;
+  }
+  ObjectFile &Obj = *ObjOrErr.get();
+
+  auto Start = std::chrono::steady_clock::now();
+  std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(Obj);
+  locstats::collectLocstats(Obj, *DICtx, "<fuzz input>", nulls());
+  auto Elapsed = std::chrono::steady_clock::now() - Start;
+
+  auto Budget = BaseBudget + BudgetPerByte * (int64_t)size;
+  if (Elapsed > Budget) {
+    errs() << "llvm-locstats-fuzzer: took "
+           << std::chrono::duration_cast<std::chrono::milliseconds>(Elapsed)
+                  .count()
+           << " ms for " << size << " bytes, more than the "
+           << std::chrono::duration_cast<std::chrono::milliseconds>(Budget)
+                  .count()
+           << " ms allowed\n";
+    abort();
+  }
+  return 0;
+}
@@ -10,27 +10,54 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "CoverageSketch.h"
+#include "DebugFileLookup.h"
+#include "DieNameCache.h"
+#include "LineHeatmap.h"
+#include "LocListCompaction.h"
+#include "LocStats.h"
+#include "PerfCounters.h"
+#include "TimeTrace.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugAranges.h"
+#include "llvm/DebugInfo/DWARF/DWARFDebugFrame.h"
+#include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/MachOUniversal.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Format.h"
-#include "llvm/Support/InitLLVM.h"
-#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
+#include <mutex>
 
 #define DEBUG_TYPE "locstats"
 using namespace llvm;
 using namespace object;
 
+STATISTIC(NumLocationLists, "Number of location lists decoded");
+STATISTIC(NumLocationListEntries, "Number of location list entries decoded");
+STATISTIC(NumRangeLists, "Number of range lists decoded");
+STATISTIC(MaxUnitArenaBytes, "Largest per-unit arena, in bytes");
+
 /// This represents the largest category of debug location coverage being
 /// calculated. The first category is 0% location coverage, but the last
 /// category is 100% location coverage.
 static const int largest_cov_category = 12;
 
+/// The ways compile units can be grouped in the report.
+enum class GroupKind { None, Producer, OptLevel };
+
 /// @}
 /// Command line options.
 /// @{
@@ -68,32 +95,865 @@ static opt<bool>
     IgnoreEntryValues("ignore-entry-values",
          desc("Ignore the location statistics on locations with entry values."),
          cat(LocStatsCategory));
+static list<std::string>
+    DebugFileDirectories("debug-file-directory",
+         desc("Search <dir> for separate debug files of stripped binaries "
+              "(default: /usr/lib/debug)."),
+         value_desc("dir"), ZeroOrMore, cat(LocStatsCategory));
+static opt<std::string>
+    DebugFileIndex("debug-file-index",
+         desc("Keep the build-id to debug file mapping in <file>, so that "
+              "the debug directories are scanned only once."),
+         value_desc("file"), cat(LocStatsCategory));
+static opt<bool>
+    RescanDebugFileIndex("rescan-debug-file-index",
+         desc("Scan the debug directories again if the -debug-file-index "
+              "has no debug file for the input."),
+         cat(LocStatsCategory));
+static list<std::string>
+    AddressRanges("address-range",
+         desc("Calculate the location statistics only for code within "
+              "[<lo>, <hi>). May be specified multiple times."),
+         value_desc("lo-hi"), ZeroOrMore, CommaSeparated,
+         cat(LocStatsCategory));
+static opt<GroupKind>
+    GroupBy("group-by",
+         desc("Report the location statistics separately for each group of "
+              "compile units."),
+         values(clEnumValN(GroupKind::Producer, "producer",
+                           "group by DW_AT_producer"),
+                clEnumValN(GroupKind::OptLevel, "opt-level",
+                           "group by the -O flag recorded in DW_AT_producer")),
+         init(GroupKind::None), cat(LocStatsCategory));
+static opt<bool>
+    ShowDistribution("distribution",
+         desc("Also print the exact per-percent coverage counts and the "
+              "coverage percentiles, by vars and by scope bytes."),
+         cat(LocStatsCategory));
+static opt<bool>
+    ShowCallSites("call-sites",
+         desc("Also print the call site statistics and how many of the "
+              "entry value bytes can be recovered through call site "
+              "parameters."),
+         cat(LocStatsCategory));
+static opt<std::string>
+    SaveStats("save-stats",
+         desc("Save the location statistics to <file>, to be combined with "
+              "others by -merge-stats."),
+         value_desc("file"), cat(LocStatsCategory));
+static list<std::string>
+    MergeStats("merge-stats",
+         desc("Add the location statistics saved in <file> by -save-stats. "
+              "May be specified multiple times."),
+         value_desc("file"), ZeroOrMore, cat(LocStatsCategory));
+static opt<unsigned>
+    NumThreads("num-threads",
+         desc("Traverse the compile units on <N> threads; 0 uses all "
+              "hardware threads (default: 1)."),
+         value_desc("N"), init(1), cat(LocStatsCategory));
+static opt<unsigned>
+    SplitUnitDies("split-unit-dies",
+         desc("With more than one thread, split the compile units of more "
+              "than <N> DIEs into parts traversed in parallel; 0 never "
+              "splits (default: 100000)."),
+         value_desc("N"), init(100000), cat(LocStatsCategory));
+static opt<std::string>
+    DumpVars("dump-vars",
+         desc("Write a CSV row per variable (or formal parameter) with its "
+              "scope and coverage to <file>."),
+         value_desc("file"), cat(LocStatsCategory));
+static opt<std::string>
+    LineHeatmapFile("line-heatmap",
+         desc("Write a CSV row per source line with how many of the "
+              "variables in scope at its addresses have a location to "
+              "<file>."),
+         value_desc("file"), cat(LocStatsCategory));
+static opt<std::string>
+    LocCompactionFile("loc-compaction",
+         desc("Write a CSV row per compile unit with the location list "
+              "entries that could be merged or dropped, the identical lists "
+              "and the size of the lists as DWARF v5 .debug_loclists to "
+              "<file>, and also print their totals."),
+         value_desc("file"), cat(LocStatsCategory));
+static opt<bool>
+    CFIAware("cfi-aware",
+         desc("Only count the frame based locations (DW_OP_fbreg, "
+              "DW_OP_call_frame_cfa) at the addresses where .eh_frame or "
+              ".debug_frame lets a debugger compute the frame."),
+         cat(LocStatsCategory));
+static opt<bool>
+    ShowGlobals("globals",
+         desc("Also print the statistics of the global and static variables, "
+              "and the data symbols that have no debug info."),
+         cat(LocStatsCategory));
+static opt<bool>
+    ShowInlineDepth("inline-depth",
+         desc("Also print the coverage by depth of inlining, from the "
+              "concrete functions (0) to the most deeply nested inlined "
+              "instances."),
+         cat(LocStatsCategory));
+static opt<std::string>
+    TimeTraceFile("time-trace",
+         desc("Write a Chrome trace of the loading, the traversal of each "
+              "unit on each thread and the reporting to <file>."),
+         value_desc("file"), cat(LocStatsCategory));
+static opt<unsigned>
+    TimeTraceGranularity("time-trace-granularity",
+         desc("Leave the events shorter than <N> microseconds out of "
+              "-time-trace (default: 500)."),
+         value_desc("N"), init(500), cat(LocStatsCategory));
+static opt<bool>
+    ShowPerfCounters("perf-counters",
+         desc("Also print the time, cycles, instructions, cache misses and "
+              "branch misses of each phase, and add them to the unit events "
+              "of -time-trace (Linux only)."),
+         cat(LocStatsCategory));
 } // namespace
 /// @}
 //===----------------------------------------------------------------------===//
 
+/// The -dump-vars output, if requested.
+static raw_ostream *VarDumpOS = nullptr;
+/// The -line-heatmap output, if requested.
+static raw_ostream *HeatmapOS = nullptr;
+/// The -loc-compaction output, if requested.
+static raw_ostream *CompactionOS = nullptr;
+
 using HandlerFn = std::function<void(ObjectFile &, DWARFContext &DICtx, Twine,
                                      raw_ostream &)>;
 
-/// Extract the low pc from a Die.
-static uint64_t getLowPC(DWARFDie Die) {
-  auto RangesOrError = Die.getAddressRanges();
+namespace {
+/// The set of address ranges the statistics are restricted to. An empty
+/// window does not restrict anything.
+class AddressWindow {
+  /// Sorted, non-overlapping ranges.
   DWARFAddressRangesVector Ranges;
-  if (RangesOrError)
-    Ranges = RangesOrError.get();
-  else
-    llvm::consumeError(RangesOrError.takeError());
+
+public:
+  void addRange(uint64_t LowPC, uint64_t HighPC) {
+    if (LowPC < HighPC)
+      Ranges.push_back({LowPC, HighPC});
+  }
+
+  /// Sort the ranges and merge the overlapping ones.
+  void finalize() {
+    llvm::sort(Ranges);
+    DWARFAddressRangesVector Merged;
+    for (const auto &R : Ranges) {
+      if (!Merged.empty() && R.LowPC <= Merged.back().HighPC)
+        Merged.back().HighPC = std::max(Merged.back().HighPC, R.HighPC);
+      else
+        Merged.push_back(R);
+    }
+    Ranges = std::move(Merged);
+  }
+
+  bool empty() const { return Ranges.empty(); }
+  const DWARFAddressRangesVector &ranges() const { return Ranges; }
+
+  /// Return the number of bytes of [LowPC, HighPC) within the window.
+  uint64_t getOverlap(uint64_t LowPC, uint64_t HighPC) const {
+    if (HighPC <= LowPC)
+      return 0;
+    if (Ranges.empty())
+      return HighPC - LowPC;
+    uint64_t Bytes = 0;
+    for (auto It = llvm::bsearch(Ranges,
+                                 [=](const DWARFAddressRange &R) {
+                                   return LowPC < R.HighPC;
+                                 });
+         It != Ranges.end() && It->LowPC < HighPC; ++It)
+      Bytes += std::min(HighPC, It->HighPC) - std::max(LowPC, It->LowPC);
+    return Bytes;
+  }
+
+  /// Call \p Handle on each part of [LowPC, HighPC) within the window, in
+  /// address order.
+  void forEachOverlap(uint64_t LowPC, uint64_t HighPC,
+                      function_ref<void(uint64_t, uint64_t)> Handle) const {
+    if (HighPC <= LowPC)
+      return;
+    if (Ranges.empty())
+      return Handle(LowPC, HighPC);
+    for (auto It = llvm::bsearch(Ranges,
+                                 [=](const DWARFAddressRange &R) {
+                                   return LowPC < R.HighPC;
+                                 });
+         It != Ranges.end() && It->LowPC < HighPC; ++It)
+      Handle(std::max(LowPC, It->LowPC), std::min(HighPC, It->HighPC));
+  }
+
+  /// Return the number of bytes of [LowPC, HighPC) within both these ranges
+  /// and \p Window. Unlike getOverlap(), empty ranges cover nothing.
+  ///
+  /// \p Cursor is the index of the range the previous call stopped at. The
+  /// calls mostly come in address order, as the entries of the location lists
+  /// of a function do, so the ranges are walked along with them and only
+  /// searched when the addresses jump backwards or far ahead.
+  uint64_t getOverlap(uint64_t LowPC, uint64_t HighPC,
+                      const AddressWindow &Window, size_t &Cursor) const {
+    if (HighPC <= LowPC)
+      return 0;
+    auto EndsBefore = [=](const DWARFAddressRange &R) {
+      return R.HighPC <= LowPC;
+    };
+    auto It = Ranges.begin() + std::min(Cursor, Ranges.size());
+    if (It != Ranges.begin() && !EndsBefore(*std::prev(It)))
+      It = Ranges.begin();
+    if (It != Ranges.end() && EndsBefore(*It) &&
+        ++It != Ranges.end() && EndsBefore(*It))
+      It = std::partition_point(It, Ranges.end(), EndsBefore);
+    Cursor = It - Ranges.begin();
+
+    uint64_t Bytes = 0;
+    for (; It != Ranges.end() && It->LowPC < HighPC; ++It)
+      Bytes += Window.getOverlap(std::max(LowPC, It->LowPC),
+                                 std::min(HighPC, It->HighPC));
+    return Bytes;
+  }
+};
+
+/// The coverage of the variables at one depth of inlining.
+struct InlineDepthStats {
+  /// The coverage distribution, weighted by variables.
+  locstats::CoverageSketch Coverage;
+  uint64_t Vars = 0;
+  double TotalCoverage = 0.0;
+  uint64_t ScopeBytes = 0;
+  uint64_t CoveredBytes = 0;
+
+  void merge(const InlineDepthStats &Other) {
+    Coverage.merge(Other.Coverage);
+    Vars += Other.Vars;
+    TotalCoverage += Other.TotalCoverage;
+    ScopeBytes += Other.ScopeBytes;
+    CoveredBytes += Other.CoveredBytes;
+  }
+};
+
+/// The location statistics of a set of compile units.
+struct LocationStats {
+  /// The coverage distribution, weighted by variables.
+  locstats::CoverageSketch VarCoverage;
+  /// The coverage distribution, weighted by the bytes in scope.
+  locstats::CoverageSketch ByteCoverage;
+  unsigned long CumulNumOfVars = 0;
+  double TotalAverage = 0.0;
+  uint64_t ScopeBytes = 0;
+  uint64_t CoveredBytes = 0;
+  /// Call sites, and those describing some parameter.
+  uint64_t CallSites = 0;
+  uint64_t CallSitesWithParams = 0;
+  uint64_t CallSiteParams = 0;
+  /// Bytes whose location is an entry value, and those where the value can be
+  /// recovered through a call site parameter describing the same register.
+  uint64_t EntryValueBytes = 0;
+  uint64_t RecoverableEntryValueBytes = 0;
+  /// Functions discarded by the linker, and their variables, none of which
+  /// are counted above.
+  uint64_t DiscardedFunctions = 0;
+  uint64_t DiscardedVars = 0;
+  /// Bytes covered by frame based locations, and those of them where no FDE
+  /// describes the frame, which -cfi-aware does not count as covered.
+  uint64_t FrameBasedBytes = 0;
+  uint64_t FrameBasedBytesWithoutCFI = 0;
+  /// Variables with static or thread storage duration. They have no scope
+  /// bytes to cover, so they are counted apart from the ones above.
+  uint64_t Globals = 0;
+  uint64_t GlobalsWithAddress = 0;
+  uint64_t GlobalsWithConstValue = 0;
+  uint64_t GlobalsWithoutLocation = 0;
+  uint64_t TLSGlobals = 0;
+  /// The variables of the concrete functions, then of the inlined instances
+  /// nested 1, 2, ... levels deep.
+  std::vector<InlineDepthStats> ByInlineDepth;
+  /// The compaction opportunities of the location lists, for
+  /// -loc-compaction.
+  locstats::LocCompactionStats LocCompaction;
+
+  InlineDepthStats &getInlineDepthStats(uint32_t Depth) {
+    if (ByInlineDepth.size() <= Depth)
+      ByInlineDepth.resize(Depth + 1);
+    return ByInlineDepth[Depth];
+  }
+
+  void merge(const LocationStats &Other) {
+    VarCoverage.merge(Other.VarCoverage);
+    ByteCoverage.merge(Other.ByteCoverage);
+    CumulNumOfVars += Other.CumulNumOfVars;
+    TotalAverage += Other.TotalAverage;
+    ScopeBytes += Other.ScopeBytes;
+    CoveredBytes += Other.CoveredBytes;
+    CallSites += Other.CallSites;
+    CallSitesWithParams += Other.CallSitesWithParams;
+    CallSiteParams += Other.CallSiteParams;
+    EntryValueBytes += Other.EntryValueBytes;
+    RecoverableEntryValueBytes += Other.RecoverableEntryValueBytes;
+    DiscardedFunctions += Other.DiscardedFunctions;
+    DiscardedVars += Other.DiscardedVars;
+    FrameBasedBytes += Other.FrameBasedBytes;
+    FrameBasedBytesWithoutCFI += Other.FrameBasedBytesWithoutCFI;
+    Globals += Other.Globals;
+    GlobalsWithAddress += Other.GlobalsWithAddress;
+    GlobalsWithConstValue += Other.GlobalsWithConstValue;
+    GlobalsWithoutLocation += Other.GlobalsWithoutLocation;
+    TLSGlobals += Other.TLSGlobals;
+    for (uint32_t Depth = 0; Depth < Other.ByInlineDepth.size(); ++Depth)
+      getInlineDepthStats(Depth).merge(Other.ByInlineDepth[Depth]);
+    LocCompaction.merge(Other.LocCompaction);
+  }
+
+  json::Value toJSON() const {
+    json::Array Depths;
+    for (const InlineDepthStats &AtDepth : ByInlineDepth)
+      Depths.push_back(json::Object{{"vars", (int64_t)AtDepth.Vars},
+                                    {"total_coverage", AtDepth.TotalCoverage},
+                                    {"scope_bytes",
+                                     (int64_t)AtDepth.ScopeBytes},
+                                    {"covered_bytes",
+                                     (int64_t)AtDepth.CoveredBytes},
+                                    {"coverage", AtDepth.Coverage.toJSON()}});
+    return json::Object{{"vars", (int64_t)CumulNumOfVars},
+                        {"total_average", TotalAverage},
+                        {"scope_bytes", (int64_t)ScopeBytes},
+                        {"covered_bytes", (int64_t)CoveredBytes},
+                        {"call_sites", (int64_t)CallSites},
+                        {"call_sites_with_params", (int64_t)CallSitesWithParams},
+                        {"call_site_params", (int64_t)CallSiteParams},
+                        {"entry_value_bytes", (int64_t)EntryValueBytes},
+                        {"recoverable_entry_value_bytes",
+                         (int64_t)RecoverableEntryValueBytes},
+                        {"discarded_functions", (int64_t)DiscardedFunctions},
+                        {"discarded_vars", (int64_t)DiscardedVars},
+                        {"frame_based_bytes", (int64_t)FrameBasedBytes},
+                        {"frame_based_bytes_without_cfi",
+                         (int64_t)FrameBasedBytesWithoutCFI},
+                        {"globals", (int64_t)Globals},
+                        {"globals_with_address", (int64_t)GlobalsWithAddress},
+                        {"globals_with_const_value",
+                         (int64_t)GlobalsWithConstValue},
+                        {"globals_without_location",
+                         (int64_t)GlobalsWithoutLocation},
+                        {"tls_globals", (int64_t)TLSGlobals},
+                        {"by_inline_depth", std::move(Depths)},
+                        {"loc_compaction", LocCompaction.toJSON()},
+                        {"var_coverage", VarCoverage.toJSON()},
+                        {"byte_coverage", ByteCoverage.toJSON()}};
+  }
+
+  bool fromJSON(const json::Value &V) {
+    const json::Object *O = V.getAsObject();
+    if (!O)
+      return false;
+    llvm::Optional<int64_t> Vars = O->getInteger("vars");
+    llvm::Optional<double> Average = O->getNumber("total_average");
+    llvm::Optional<int64_t> Scope = O->getInteger("scope_bytes");
+    llvm::Optional<int64_t> Covered = O->getInteger("covered_bytes");
+    const json::Value *Var = O->get("var_coverage");
+    const json::Value *Byte = O->get("byte_coverage");
+    if (!Vars || !Average || !Scope || !Covered || !Var || !Byte)
+      return false;
+    CumulNumOfVars += *Vars;
+    TotalAverage += *Average;
+    ScopeBytes += *Scope;
+    CoveredBytes += *Covered;
+    // These were added later; older files do not have them.
+    CallSites += O->getInteger("call_sites").getValueOr(0);
+    CallSitesWithParams +=
+        O->getInteger("call_sites_with_params").getValueOr(0);
+    CallSiteParams += O->getInteger("call_site_params").getValueOr(0);
+    EntryValueBytes += O->getInteger("entry_value_bytes").getValueOr(0);
+    RecoverableEntryValueBytes +=
+        O->getInteger("recoverable_entry_value_bytes").getValueOr(0);
+    DiscardedFunctions += O->getInteger("discarded_functions").getValueOr(0);
+    DiscardedVars += O->getInteger("discarded_vars").getValueOr(0);
+    FrameBasedBytes += O->getInteger("frame_based_bytes").getValueOr(0);
+    FrameBasedBytesWithoutCFI +=
+        O->getInteger("frame_based_bytes_without_cfi").getValueOr(0);
+    Globals += O->getInteger("globals").getValueOr(0);
+    GlobalsWithAddress += O->getInteger("globals_with_address").getValueOr(0);
+    GlobalsWithConstValue +=
+        O->getInteger("globals_with_const_value").getValueOr(0);
+    GlobalsWithoutLocation +=
+        O->getInteger("globals_without_location").getValueOr(0);
+    TLSGlobals += O->getInteger("tls_globals").getValueOr(0);
+    if (const json::Array *Depths = O->getArray("by_inline_depth")) {
+      for (uint32_t Depth = 0; Depth < Depths->size(); ++Depth) {
+        const json::Object *D = (*Depths)[Depth].getAsObject();
+        if (!D)
+          return false;
+        InlineDepthStats &AtDepth = getInlineDepthStats(Depth);
+        AtDepth.Vars += D->getInteger("vars").getValueOr(0);
+        AtDepth.TotalCoverage += D->getNumber("total_coverage").getValueOr(0);
+        AtDepth.ScopeBytes += D->getInteger("scope_bytes").getValueOr(0);
+        AtDepth.CoveredBytes += D->getInteger("covered_bytes").getValueOr(0);
+        // Older files do not have the distribution.
+        if (const json::Value *Coverage = D->get("coverage"))
+          if (!AtDepth.Coverage.fromJSON(*Coverage))
+            return false;
+      }
+    }
+    if (const json::Value *Compaction = O->get("loc_compaction"))
+      if (!LocCompaction.fromJSON(*Compaction))
+        return false;
+    return VarCoverage.fromJSON(*Var) && ByteCoverage.fromJSON(*Byte);
+  }
+};
+
+/// The statistics of each -group-by group.
+using GroupedStats = std::map<std::string, LocationStats>;
+
+/// Call site parameters indexed by callee during the traversal, used to tell
+/// which entry values a debugger can actually recover.
+struct CallSiteIndex {
+  /// (callee, DWARF register) pairs described by some call site parameter.
+  DenseSet<std::pair<uint64_t, uint64_t>> DescribedParams;
+
+  /// Bytes covered by the entry value of a register within a function.
+  struct EntryValueUse {
+    LocationStats *Stats;
+    uint64_t Function;
+    uint64_t Reg;
+    uint64_t Bytes;
+  };
+  std::vector<EntryValueUse> EntryValues;
+
+  /// Join the entry values with the described call site parameters, once
+  /// all units have been traversed.
+  void resolve() {
+    for (const EntryValueUse &Use : EntryValues)
+      if (DescribedParams.count({Use.Function, Use.Reg}))
+        Use.Stats->RecoverableEntryValueBytes += Use.Bytes;
+    EntryValues.clear();
+  }
+};
+
+/// The results of the traversal of one unit, or of a part of it, combined
+/// with the others in unit order once it is done.
+struct UnitResult {
+  UnitResult(DWARFUnit *Unit, LocationStats *GroupStats, uint32_t FirstDie = 0,
+             uint32_t EndDie = UINT32_MAX)
+      : Unit(Unit), GroupStats(GroupStats), FirstDie(FirstDie),
+        EndDie(EndDie) {}
+
+  DWARFUnit *Unit;
+  LocationStats *GroupStats;
+  /// The DIEs to traverse, [FirstDie, EndDie) by index in the non-skeleton
+  /// unit. A part of a unit starts at a child of the unit DIE.
+  uint32_t FirstDie;
+  uint32_t EndDie;
+  LocationStats Stats;
+  CallSiteIndex CallSites;
+  /// The -dump-vars rows of the unit.
+  std::string VarRows;
+  locstats::LineHeatmap Heatmap;
+  /// The location lists decoded in the unit, for -loc-compaction.
+  locstats::LocListCompaction Compaction;
+  /// The addresses of the global variables, checked against the symbol
+  /// table for -globals.
+  std::vector<uint64_t> GlobalAddresses;
+  bool Done = false;
+};
+} // namespace
+
+/// The state of the traversal of one unit.
+struct TraversalState {
+  TraversalState(LocationStats &Stats, LocationStats &GroupStats,
+                 CallSiteIndex &CallSites, const AddressWindow &Window)
+      : Stats(Stats), GroupStats(GroupStats), CallSites(CallSites),
+        Window(Window) {}
+
+  LocationStats &Stats;
+  /// The statistics of the whole group, which receive the entry value bytes
+  /// recovered through call sites once all the units are traversed.
+  LocationStats &GroupStats;
+  CallSiteIndex &CallSites;
+  const AddressWindow &Window;
+  /// Whether the locations are checked for entry values, which parses every
+  /// location expression, and whether the call sites are indexed. Both are
+  /// only needed by the reports that use them.
+  bool EntryValues = false;
+  bool CallSiteIndexing = false;
+  /// The executable sections of a linked binary, or null for relocatable
+  /// objects, whose addresses are section relative.
+  const AddressWindow *Code = nullptr;
+  /// The ranges described by FDEs for -cfi-aware, and where the last lookup
+  /// in them stopped.
+  const AddressWindow *Unwind = nullptr;
+  size_t UnwindCursor = 0;
+  /// Where the addresses of the global variables go, for -globals.
+  std::vector<uint64_t> *GlobalAddresses = nullptr;
+  /// Where the -dump-vars rows go, if requested.
+  raw_ostream *VarRows = nullptr;
+  /// The names of the functions and variables, shared by all the units.
+  locstats::DieNameCache *Names = nullptr;
+  /// The -line-heatmap of the unit and its line table, if requested.
+  locstats::LineHeatmap *Heatmap = nullptr;
+  const locstats::CompactLineTable *LineTable = nullptr;
+  /// Where the location lists decoded in the unit are analyzed, if
+  /// -loc-compaction is requested.
+  locstats::LocListCompaction *Compaction = nullptr;
+  /// Transient data of the unit being traversed, such as its decoded
+  /// location lists. It is released in one go when the unit is done.
+  BumpPtrAllocator UnitArena;
+};
+
+/// A location list entry, with absolute addresses. The expression refers to
+/// the section data.
+struct LocationEntry {
+  uint64_t Begin;
+  uint64_t End;
+  StringRef Expr;
+};
+
+/// Return true if the linker discarded the code of a function: its ranges all
+/// have a tombstone address, or lie outside of the executable sections.
+static bool isDiscardedFunction(ArrayRef<DWARFAddressRange> Ranges,
+                                DWARFUnit *U, const AddressWindow *Code) {
+  if (Ranges.empty())
+    return false;
+  // Linkers resolve the addresses of discarded code to 0, -1 or -2. Zero is
+  // caught by the executable sections, since it may be a valid address.
+  const uint64_t Tombstone = maxUIntN(U->getAddressByteSize() * 8) - 1;
+  for (const DWARFAddressRange &Range : Ranges) {
+    if (Range.LowPC >= Tombstone)
+      continue;
+    if (!Code || Code->getOverlap(Range.LowPC, Range.HighPC))
+      return false;
+  }
+  return true;
+}
+
+/// Extract the low pc from a Die, given its address ranges.
+static uint64_t getLowPC(DWARFDie Die, ArrayRef<DWARFAddressRange> Ranges) {
   if (Ranges.size())
     return Ranges[0].LowPC;
   return dwarf::toAddress(Die.find(dwarf::DW_AT_low_pc), 0);
 }
 
-static void collectLocStatsForDie(DWARFDie Die, uint64_t ScopeLowPC,
-                                  uint64_t BytesInScope,
-                                  std::map<int, unsigned long> &LocStatistics,
-                                  unsigned &CumulNumOfVars,
-                                  double &TotalAverage,
-                                  DWARFContext &DICtx) {
+/// Return the size of a unit in .debug_info, header included.
+static uint64_t getUnitSize(const DWARFUnit &U) {
+  return U.getNextUnitOffset() - U.getOffset();
+}
+
+/// The size of the segments of .debug_info in which the DIEs of a unit are
+/// decoded concurrently, enough to outweigh the cost of a task.
+static const uint32_t ExtractSegmentSize = 1 << 20;
+
+/// Decode the .debug_loc list at \p Offset into the unit arena. Unlike
+/// DWARFDebugLoc, this neither parses the whole section up front nor copies
+/// the location expressions. The list is also analyzed by \p Compaction, if
+/// set and if it has not seen the list yet.
+static llvm::Optional<ArrayRef<LocationEntry>>
+decodeLocationList(DWARFUnit *U, uint64_t Offset, BumpPtrAllocator &UnitArena,
+                   locstats::LocListCompaction *Compaction) {
+  const DWARFSection *LocSection = U->getLocSection();
+  if (U->isDWOUnit() || !LocSection)
+    return None;
+  locstats::TimeTraceScope TimeScope("Decode location list", U->getOffset(),
+                                     getUnitSize(*U));
+  DWARFContext &DICtx = U->getContext();
+  DWARFDataExtractor Data(DICtx.getDWARFObj(), *LocSection,
+                          DICtx.isLittleEndian(), U->getAddressByteSize());
+
+  // Entries are relative to the unit's base address, unless a base address
+  // selection entry sets a new one.
+  uint64_t BaseAddr = 0;
+  if (auto UnitBase = U->getBaseAddress())
+    BaseAddr = UnitBase->Address;
+  const uint64_t UnitBaseAddr = BaseAddr;
+  const uint64_t MaxAddr = maxUIntN(U->getAddressByteSize() * 8);
+  if (Compaction && Compaction->contains(Offset))
+    Compaction = nullptr;
+
+  SmallVector<LocationEntry, 8> Entries;
+  SmallVector<locstats::RawLocEntry, 8> RawEntries;
+  uint64_t Cursor = Offset;
+  while (true) {
+    if (!Data.isValidOffsetForDataOfSize(Cursor, 2 * U->getAddressByteSize()))
+      return None;
+    uint64_t Begin = Data.getRelocatedAddress(&Cursor);
+    uint64_t End = Data.getRelocatedAddress(&Cursor);
+    // The end of list entry.
+    if (Begin == 0 && End == 0)
+      break;
+    if (Begin == MaxAddr) {
+      BaseAddr = End;
+      if (Compaction)
+        RawEntries.push_back({Begin, End, StringRef(), true});
+      continue;
+    }
+    if (!Data.isValidOffsetForDataOfSize(Cursor, 2))
+      return None;
+    uint16_t Bytes = Data.getU16(&Cursor);
+    if (!Data.isValidOffsetForDataOfSize(Cursor, Bytes))
+      return None;
+    StringRef Expr = Data.getData().substr(Cursor, Bytes);
+    Entries.push_back({BaseAddr + Begin, BaseAddr + End, Expr});
+    if (Compaction)
+      RawEntries.push_back({Begin, End, Expr, false});
+    Cursor += Bytes;
+  }
+  if (Compaction)
+    Compaction->addList(Offset, RawEntries, UnitBaseAddr,
+                        U->getAddressByteSize());
+
+  ++NumLocationLists;
+  NumLocationListEntries += Entries.size();
+  LocationEntry *Copy = UnitArena.Allocate<LocationEntry>(Entries.size());
+  std::uninitialized_copy(Entries.begin(), Entries.end(), Copy);
+  return makeArrayRef(Copy, Entries.size());
+}
+
+/// Copy \p Ranges into the unit arena.
+static ArrayRef<DWARFAddressRange>
+copyToArena(ArrayRef<DWARFAddressRange> Ranges, BumpPtrAllocator &UnitArena) {
+  DWARFAddressRange *Copy =
+      UnitArena.Allocate<DWARFAddressRange>(Ranges.size());
+  std::uninitialized_copy(Ranges.begin(), Ranges.end(), Copy);
+  return makeArrayRef(Copy, Ranges.size());
+}
+
+/// Return the address ranges of a scope, in the unit arena. The .debug_ranges
+/// lists are decoded in place, like the location lists; only the DWARF v5
+/// range lists go through DWARFDie::getAddressRanges() and its vector.
+static Expected<ArrayRef<DWARFAddressRange>>
+getScopeRanges(DWARFDie Die, BumpPtrAllocator &UnitArena) {
+  uint64_t LowPC, HighPC, Index;
+  if (Die.getLowAndHighPC(LowPC, HighPC, Index))
+    return copyToArena(DWARFAddressRange(LowPC, HighPC, Index), UnitArena);
+  llvm::Optional<DWARFFormValue> Value = Die.find(dwarf::DW_AT_ranges);
+  if (!Value)
+    return ArrayRef<DWARFAddressRange>();
+
+  DWARFUnit *U = Die.getDwarfUnit();
+  const DWARFSection *RangesSection = U->getRangesSection();
+  if (U->getVersion() >= 5 || !RangesSection) {
+    auto RangesOrError = Die.getAddressRanges();
+    if (!RangesOrError)
+      return RangesOrError.takeError();
+    return copyToArena(*RangesOrError, UnitArena);
+  }
+
+  DWARFContext &DICtx = U->getContext();
+  DWARFDataExtractor Data(DICtx.getDWARFObj(), *RangesSection,
+                          DICtx.isLittleEndian(), U->getAddressByteSize());
+  llvm::Optional<object::SectionedAddress> BaseAddr = U->getBaseAddress();
+  const uint64_t MaxAddr = maxUIntN(U->getAddressByteSize() * 8);
+  SmallVector<DWARFAddressRange, 8> Ranges;
+  uint64_t Cursor =
+      U->getRangesSectionBase() + Value->getAsSectionOffset().getValueOr(0);
+  while (true) {
+    if (!Data.isValidOffsetForDataOfSize(Cursor, 2 * U->getAddressByteSize()))
+      return createStringError(errc::invalid_argument,
+                               "invalid range list entry at offset 0x%" PRIx64,
+                               Cursor);
+    uint64_t SectionIndex = -1ULL;
+    uint64_t Begin = Data.getRelocatedAddress(&Cursor);
+    uint64_t End = Data.getRelocatedAddress(&Cursor, &SectionIndex);
+    // The end of list entry.
+    if (Begin == 0 && End == 0)
+      break;
+    if (Begin == MaxAddr) {
+      BaseAddr = object::SectionedAddress{End, SectionIndex};
+      continue;
+    }
+    // As in DWARFDebugRangeList::getAbsoluteRanges().
+    if (BaseAddr) {
+      Begin += BaseAddr->Address;
+      End += BaseAddr->Address;
+      if (SectionIndex == -1ULL)
+        SectionIndex = BaseAddr->SectionIndex;
+    }
+    Ranges.push_back(DWARFAddressRange(Begin, End, SectionIndex));
+  }
+  ++NumRangeLists;
+  return copyToArena(Ranges, UnitArena);
+}
+
+/// Return true if the location expression \p Expr uses an entry value. If
+/// it is the entry value of a register, \p Reg is set to its DWARF number.
+static bool isEntryValue(StringRef Expr, DWARFUnit *U,
+                         llvm::Optional<uint64_t> &Reg) {
+  DWARFDataExtractor Data(Expr, U->getContext().isLittleEndian(),
+                          U->getAddressByteSize());
+  DWARFExpression Expression(Data, U->getVersion(), U->getAddressByteSize());
+  for (auto &Op : Expression) {
+    if (Op.getCode() != dwarf::DW_OP_entry_value &&
+        Op.getCode() != dwarf::DW_OP_GNU_entry_value)
+      continue;
+    // The operand is a ULEB128 size followed by the sub-expression, which is
+    // a register for the entry values we can recover.
+    uint32_t Offset = Op.getEndOffset();
+    uint64_t Size = Data.getULEB128(&Offset);
+    if (Size && Data.isValidOffsetForDataOfSize(Offset, Size)) {
+      uint8_t SubOp = Data.getU8(&Offset);
+      if (SubOp >= dwarf::DW_OP_reg0 && SubOp <= dwarf::DW_OP_reg31)
+        Reg = SubOp - dwarf::DW_OP_reg0;
+      else if (SubOp == dwarf::DW_OP_regx)
+        Reg = Data.getULEB128(&Offset);
+    }
+    return true;
+  }
+  return false;
+}
+
+/// Return true if the location expression \p Expr is relative to the frame,
+/// which a debugger computes from the call frame information.
+static bool isFrameBased(StringRef Expr, DWARFUnit *U) {
+  DWARFDataExtractor Data(Expr, U->getContext().isLittleEndian(),
+                          U->getAddressByteSize());
+  DWARFExpression Expression(Data, U->getVersion(), U->getAddressByteSize());
+  for (auto &Op : Expression)
+    if (Op.getCode() == dwarf::DW_OP_fbreg ||
+        Op.getCode() == dwarf::DW_OP_call_frame_cfa)
+      return true;
+  return false;
+}
+
+/// Return the DWARF register number of a DW_OP_reg* location.
+static llvm::Optional<uint64_t> getRegister(ArrayRef<uint8_t> Expr) {
+  if (Expr.empty())
+    return None;
+  if (Expr[0] >= dwarf::DW_OP_reg0 && Expr[0] <= dwarf::DW_OP_reg31)
+    return Expr[0] - dwarf::DW_OP_reg0;
+  if (Expr[0] == dwarf::DW_OP_regx) {
+    unsigned Length;
+    return decodeULEB128(Expr.data() + 1, &Length, Expr.end());
+  }
+  return None;
+}
+
+/// Return the offset identifying the function \p Die belongs to: concrete
+/// instances and definitions are mapped to the abstract instance or the
+/// declaration they refer to, as call sites may name either.
+static uint64_t getFunctionKey(DWARFDie Die, locstats::DieNameCache &Names) {
+  // Bound the walk in case of malformed, cyclic references.
+  for (unsigned I = 0; I < 8; ++I) {
+    DWARFDie Origin =
+        Names.getReferencedDie(Die, dwarf::DW_AT_abstract_origin);
+    if (!Origin)
+      Origin = Names.getReferencedDie(Die, dwarf::DW_AT_specification);
+    if (!Origin)
+      break;
+    Die = Origin;
+  }
+  return Die.getOffset();
+}
+
+/// Record a DW_TAG_call_site (or its GNU counterpart) and index its
+/// parameters by callee.
+static void collectCallSiteStats(DWARFDie Die, TraversalState &State) {
+  LocationStats &Stats = State.Stats;
+  const AddressWindow &Window = State.Window;
+  if (!Window.empty()) {
+    auto PC = dwarf::toAddress(Die.find({dwarf::DW_AT_call_return_pc,
+                                         dwarf::DW_AT_call_pc,
+                                         dwarf::DW_AT_low_pc}));
+    if (!PC || !Window.getOverlap(*PC, *PC + 1))
+      return;
+  }
+
+  locstats::DieNameCache &Names = *State.Names;
+  DWARFDie Callee = Names.getReferencedDie(Die, dwarf::DW_AT_call_origin);
+  if (!Callee)
+    Callee = Names.getReferencedDie(Die, dwarf::DW_AT_abstract_origin);
+  uint64_t CalleeKey = Callee ? getFunctionKey(Callee, Names) : -1ULL;
+
+  uint64_t NumParams = 0;
+  for (DWARFDie Child = Die.getFirstChild(); Child;
+       Child = Child.getSibling()) {
+    if (Child.getTag() != dwarf::DW_TAG_call_site_parameter &&
+        Child.getTag() != dwarf::DW_TAG_GNU_call_site_parameter)
+      continue;
+    // A parameter is only useful if its value at the call is known.
+    if (!Child.find({dwarf::DW_AT_call_value, dwarf::DW_AT_GNU_call_site_value}))
+      continue;
+    ++NumParams;
+    if (!Callee)
+      continue;
+    if (auto Loc = dwarf::toBlock(Child.find(dwarf::DW_AT_location)))
+      if (auto Reg = getRegister(*Loc))
+        State.CallSites.DescribedParams.insert({CalleeKey, *Reg});
+  }
+
+  ++Stats.CallSites;
+  if (NumParams)
+    ++Stats.CallSitesWithParams;
+  Stats.CallSiteParams += NumParams;
+}
+
+/// The innermost function, inlined instance or lexical block enclosing the
+/// DIEs being visited.
+struct ScopeFrame {
+  DWARFDie Die;
+  uint32_t Depth;
+  uint64_t ScopeLowPC;
+  uint64_t BytesInScope;
+  uint64_t FunctionKey;
+  /// The number of inlined instances between the scope and its concrete
+  /// function.
+  uint32_t InlineDepth;
+  /// The address ranges of the scope, in the unit arena, and for a function
+  /// the start of its events in the heatmap.
+  ArrayRef<DWARFAddressRange> Ranges;
+  size_t HeatmapMark;
+};
+
+/// Write \p Field as a CSV field, quoted if needed.
+static void writeCSVField(raw_ostream &OS, StringRef Field) {
+  if (Field.find_first_of(",\"\n") == StringRef::npos) {
+    OS << Field;
+    return;
+  }
+  OS << '"';
+  for (char C : Field) {
+    if (C == '"')
+      OS << '"';
+    OS << C;
+  }
+  OS << '"';
+}
+
+/// Write the -dump-vars row of a variable.
+static void dumpVar(raw_ostream &OS, locstats::DieNameCache &Names,
+                    DWARFDie Var, ArrayRef<ScopeFrame> Scopes,
+                    uint64_t Covered, bool HasConstValue, bool HasEntryValue) {
+  DWARFUnit *U = Var.getDwarfUnit();
+  OS << format("0x%08" PRIx64, U->getOffset()) << ',';
+  writeCSVField(OS, dwarf::toString(U->getUnitDIE().find(dwarf::DW_AT_name),
+                                    ""));
+  OS << ',';
+
+  // The concrete function, then the chain of inlined instances within it.
+  StringRef Function;
+  std::string InlineChain;
+  for (const ScopeFrame &Scope : Scopes) {
+    if (!Scope.Die)
+      continue;
+    if (Scope.Die.getTag() == dwarf::DW_TAG_subprogram) {
+      Function = Names.getName(Scope.Die, DINameKind::LinkageName);
+    } else if (Scope.Die.getTag() == dwarf::DW_TAG_inlined_subroutine) {
+      if (!InlineChain.empty())
+        InlineChain += ';';
+      InlineChain += Names.getName(Scope.Die, DINameKind::LinkageName);
+    }
+  }
+  writeCSVField(OS, Function);
+  OS << ',';
+  writeCSVField(OS, InlineChain);
+  OS << ',';
+  writeCSVField(OS, Names.getName(Var, DINameKind::ShortName));
+  OS << ',' << dwarf::TagString(Var.getTag()) << ','
+     << Scopes.back().BytesInScope << ',' << Covered << ','
+     << (HasConstValue ? 1 : 0) << ',' << (HasEntryValue ? 1 : 0) << '\n';
+}
+
+static void collectLocStatsForDie(DWARFDie Die, ArrayRef<ScopeFrame> Scopes,
+                                  TraversalState &State) {
+  LocationStats &Stats = State.Stats;
+  const uint64_t BytesInScope = Scopes.back().BytesInScope;
+  const uint64_t FunctionKey = Scopes.back().FunctionKey;
   if (Die.getTag() == dwarf::DW_TAG_variable && OnlyFormalParameters)
     return;
   if (Die.getTag() == dwarf::DW_TAG_formal_parameter && OnlyVariables)
@@ -112,41 +972,107 @@ static void collectLocStatsForDie(DWARFDie Die, uint64_t ScopeLowPC,
       Die.getParent().getTag() == dwarf::DW_TAG_subroutine_type)
     return;
 
-  if (auto name = Die.getName(DINameKind::ShortName))
-    LLVM_DEBUG(llvm::dbgs() << "    -var (or formal param): " << name << "\n");
+  LLVM_DEBUG({
+    StringRef Name = State.Names->getName(Die, DINameKind::ShortName);
+    if (!Name.empty())
+      llvm::dbgs() << "    -var (or formal param): " << Name << "\n";
+  });
 
   double Coverage = 0;
+  uint64_t Covered = 0;
+  bool HasConstValue = false;
+  bool HasEntryValue = false;
+  locstats::LineHeatmap *Heatmap = State.Heatmap;
+  // The parts of [LowPC, HighPC) within the scope of the variable and the
+  // address window, which the location bytes and the heatmap both count.
+  auto ForEachPartInScope =
+      [&](uint64_t LowPC, uint64_t HighPC,
+          function_ref<void(uint64_t, uint64_t)> Handle) {
+        for (const DWARFAddressRange &Range : Scopes.back().Ranges)
+          State.Window.forEachOverlap(std::max(LowPC, Range.LowPC),
+                                      std::min(HighPC, Range.HighPC), Handle);
+      };
+  if (Heatmap)
+    ForEachPartInScope(0, UINT64_MAX, [&](uint64_t LowPC, uint64_t HighPC) {
+      Heatmap->addScope(LowPC, HighPC);
+    });
 
-  auto IsEntryValue = [&] (StringRef D) -> bool {
-    DWARFUnit *U = Die.getDwarfUnit();
-    DataExtractor Data(D, DICtx.isLittleEndian(), 0);
-    DWARFExpression Expression(Data, U->getVersion(),
-                               U->getAddressByteSize());
-    bool IsEntryVal = llvm::any_of(Expression,
-                                  [](DWARFExpression::Operation &Op) {
-      return Op.getCode() == dwarf::DW_OP_entry_value ||
-             Op.getCode() == dwarf::DW_OP_GNU_entry_value;
+  // Account the bytes covered by an entry value, to be matched with the call
+  // site parameters of the function.
+  DWARFUnit *U = Die.getDwarfUnit();
+  auto RecordEntryValue = [&](llvm::Optional<uint64_t> Reg, uint64_t Bytes) {
+    Stats.EntryValueBytes += Bytes;
+    HasEntryValue = true;
+    if (Reg && Bytes && State.CallSiteIndexing)
+      State.CallSites.EntryValues.push_back(
+          {&State.GroupStats, FunctionKey, *Reg, Bytes});
+  };
+
+  // Drop the bytes of a frame based location where no FDE describes the
+  // frame.
+  auto RecordFrameBased = [&](uint64_t LowPC, uint64_t HighPC,
+                              uint64_t Bytes) {
+    uint64_t WithCFI = State.Unwind->getOverlap(LowPC, HighPC, State.Window,
+                                                State.UnwindCursor);
+    Stats.FrameBasedBytes += Bytes;
+    Stats.FrameBasedBytesWithoutCFI += Bytes - WithCFI;
+    return WithCFI;
+  };
+
+  // Record a location within [LowPC, HighPC), and return the bytes of the
+  // scope it covers.
+  auto RecordLocation = [&](uint64_t LowPC, uint64_t HighPC,
+                            bool FrameBased) {
+    uint64_t Bytes = 0;
+    ForEachPartInScope(LowPC, HighPC, [&](uint64_t PartLow, uint64_t PartHigh) {
+      if (!FrameBased) {
+        Bytes += PartHigh - PartLow;
+        if (Heatmap)
+          Heatmap->addLocation(PartLow, PartHigh);
+        return;
+      }
+      Bytes += RecordFrameBased(PartLow, PartHigh, PartHigh - PartLow);
+      if (Heatmap)
+        State.Unwind->forEachOverlap(PartLow, PartHigh,
+                                     [&](uint64_t Low, uint64_t High) {
+                                       Heatmap->addLocation(Low, High);
+                                     });
     });
-    return IsEntryVal;
+    return Bytes;
+  };
+  auto RecordWholeScope = [&](bool FrameBased) {
+    return std::min(RecordLocation(0, UINT64_MAX, FrameBased), BytesInScope);
   };
 
-  if (Die.find(dwarf::DW_AT_const_value))
+  if (Die.find(dwarf::DW_AT_const_value)) {
     // This catches constant members *and* variables.
+    HasConstValue = true;
     Coverage = 100;
-  else {
+    Covered = RecordWholeScope(/*FrameBased=*/false);
+  } else {
     // Handle variables and function arguments location.
     auto FormValue = Die.find(dwarf::DW_AT_location);
     if (FormValue.hasValue()) {
-      uint64_t Covered = 0;
       // Get PC coverage.
       if (auto DebugLocOffset = FormValue->getAsSectionOffset()) {
-        auto *DebugLoc = Die.getDwarfUnit()->getContext().getDebugLoc();
-        if (auto List = DebugLoc->getLocationListAtOffset(*DebugLocOffset)) {
-          for (auto Entry : List->Entries) {
-            if (IgnoreEntryValues &&
-                IsEntryValue({Entry.Loc.data(), Entry.Loc.size()}))
-              continue;
-            Covered += Entry.End - Entry.Begin;
+        if (auto List = decodeLocationList(U, *DebugLocOffset,
+                                           State.UnitArena,
+                                           State.Compaction)) {
+          for (const LocationEntry &Entry : *List) {
+            llvm::Optional<uint64_t> Reg;
+            if (State.EntryValues && isEntryValue(Entry.Expr, U, Reg)) {
+              uint64_t Bytes = 0;
+              ForEachPartInScope(Entry.Begin, Entry.End,
+                                 [&](uint64_t LowPC, uint64_t HighPC) {
+                                   Bytes += HighPC - LowPC;
+                                 });
+              RecordEntryValue(Reg, Bytes);
+              if (IgnoreEntryValues)
+                continue;
+            }
+            Covered += RecordLocation(
+                Entry.Begin, Entry.End,
+                State.Unwind && isFrameBased(Entry.Expr, U));
           }
         }
 
@@ -159,7 +1085,17 @@ static void collectLocStatsForDie(DWARFDie Die, uint64_t ScopeLowPC,
         Coverage = 100 * (double)Covered / BytesInScope;
       } else {
         // Assume the entire range is covered by a single location.
+        llvm::Optional<uint64_t> Reg;
+        auto Expr = FormValue->getAsBlock();
+        if (Expr && State.EntryValues &&
+            isEntryValue(toStringRef(*Expr), U, Reg))
+          RecordEntryValue(Reg, BytesInScope);
+        bool FrameBased =
+            Expr && State.Unwind && isFrameBased(toStringRef(*Expr), U);
         Coverage = 100;
+        Covered = RecordWholeScope(FrameBased);
+        if (FrameBased && BytesInScope)
+          Coverage = 100 * (double)Covered / BytesInScope;
       }
     } else {
       // No at_location attribute.
@@ -170,141 +1106,848 @@ static void collectLocStatsForDie(DWARFDie Die, uint64_t ScopeLowPC,
   LLVM_DEBUG(llvm::dbgs() << "      -coverage is " << (int)Coverage << "%\n");
 
   int CoverageRounded = (int)Coverage;
-  TotalAverage += CoverageRounded;
-  int PercentageKey;
-  if (CoverageRounded == 0)
-    PercentageKey = 0;
-  else if (CoverageRounded == 100)
-    PercentageKey = largest_cov_category - 1;
-  else
-    PercentageKey = CoverageRounded / 10 + 1;
-
-  LocStatistics[PercentageKey]++;
-  CumulNumOfVars++;
-}
-
-static void collectStatsRecursive(DWARFDie Die, uint64_t ScopeLowPC,
-                                  uint64_t BytesInScope,
-                                  std::map<int, unsigned long> &LocStatistics,
-                                  unsigned &CumulNumOfVars,
-                                  double &TotalAverage,
-                                  DWARFContext &DICtx) {
-  const dwarf::Tag Tag = Die.getTag();
-  const bool IsFunction = Tag == dwarf::DW_TAG_subprogram;
-  const bool IsBlock = Tag == dwarf::DW_TAG_lexical_block;
-  // TODO: Add a separate option to track inlined functions.
-  const bool IsInlinedFunction = Tag == dwarf::DW_TAG_inlined_subroutine;
-  if (IsFunction || IsInlinedFunction || IsBlock) {
-    if (auto name = Die.getName(DINameKind::ShortName))
-    LLVM_DEBUG(llvm::dbgs() << "The function beeing processed is: "
-                            << name<< "\n");
-
-    // Ignore forward declarations.
-    if (Die.find(dwarf::DW_AT_declaration)) {
-      LLVM_DEBUG(llvm::dbgs() << "  -declaration ignored\n");
-      return;
-    }
+  Stats.TotalAverage += CoverageRounded;
+  Stats.VarCoverage.add(Coverage);
+  Stats.ByteCoverage.add(Coverage, BytesInScope);
+  Stats.ScopeBytes += BytesInScope;
+  Stats.CoveredBytes += Covered;
+  Stats.CumulNumOfVars++;
+  InlineDepthStats &AtDepth =
+      Stats.getInlineDepthStats(Scopes.back().InlineDepth);
+  AtDepth.Coverage.add(Coverage);
+  AtDepth.Vars++;
+  AtDepth.TotalCoverage += CoverageRounded;
+  AtDepth.ScopeBytes += BytesInScope;
+  AtDepth.CoveredBytes += Covered;
 
-    // Ignore inlined subprograms.
-    if (Die.find(dwarf::DW_AT_inline)) {
-      LLVM_DEBUG(llvm::dbgs() << "  -inlined subprogram ignored\n");
-      return;
-    }
+  if (State.VarRows)
+    dumpVar(*State.VarRows, *State.Names, Die, Scopes, Covered, HasConstValue,
+            HasEntryValue);
+}
 
-    if (IgnoreInlined && IsInlinedFunction) {
-      LLVM_DEBUG(llvm::dbgs() << "  -an inlined instance ignored\n");
-      return;
+/// Record a variable with static or thread storage duration: one declared at
+/// file or namespace scope when \p AtFileScope, or else a static local, which
+/// is told apart by its address. Return false for any other local variable.
+static bool collectGlobalStats(DWARFDie Die, bool AtFileScope,
+                               TraversalState &State) {
+  LocationStats &Stats = State.Stats;
+  // The definition is recorded, rather than its declarations.
+  if (Die.find(dwarf::DW_AT_declaration) || Die.find(dwarf::DW_AT_artificial))
+    return AtFileScope;
+
+  if (Die.find(dwarf::DW_AT_const_value)) {
+    if (!AtFileScope)
+      return false;
+    ++Stats.Globals;
+    ++Stats.GlobalsWithConstValue;
+    return true;
+  }
+
+  auto FormValue = Die.find(dwarf::DW_AT_location);
+  llvm::Optional<ArrayRef<uint8_t>> Expr;
+  if (FormValue)
+    Expr = FormValue->getAsBlock();
+  llvm::Optional<uint64_t> Address;
+  bool IsTLS = false;
+  if (Expr) {
+    DWARFUnit *U = Die.getDwarfUnit();
+    DWARFDataExtractor Data(toStringRef(*Expr),
+                            U->getContext().isLittleEndian(),
+                            U->getAddressByteSize());
+    DWARFExpression Expression(Data, U->getVersion(),
+                               U->getAddressByteSize());
+    for (auto &Op : Expression) {
+      switch (Op.getCode()) {
+      case dwarf::DW_OP_addr:
+        Address = Op.getRawOperand(0);
+        break;
+      case dwarf::DW_OP_addrx:
+      case dwarf::DW_OP_GNU_addr_index:
+        if (auto SA = U->getAddrOffsetSectionItem(Op.getRawOperand(0)))
+          Address = SA->Address;
+        break;
+      case dwarf::DW_OP_form_tls_address:
+      case dwarf::DW_OP_GNU_push_tls_address:
+        IsTLS = true;
+        break;
+      default:
+        break;
+      }
     }
+  }
+  if (!AtFileScope && !Address)
+    return false;
 
-    // PC Ranges.
-    auto RangesOrError = Die.getAddressRanges();
-    if (!RangesOrError) {
-      llvm::consumeError(RangesOrError.takeError());
-      return;
+  ++Stats.Globals;
+  if (!FormValue)
+    ++Stats.GlobalsWithoutLocation;
+  else if (IsTLS)
+    ++Stats.TLSGlobals;
+  else if (Address) {
+    ++Stats.GlobalsWithAddress;
+    if (State.GlobalAddresses)
+      State.GlobalAddresses->push_back(*Address);
+  }
+  return true;
+}
+
+/// Visit the DIEs [FirstDie, EndDie) of a unit in order. The DIEs are stored
+/// flattened in pre-order along with their depth, so the enclosing scopes are
+/// kept on an explicit stack rather than by recursion, and the stack usage
+/// does not depend on how deeply the DIEs are nested.
+static void collectStatsForDies(DWARFUnit &U, uint32_t FirstDie,
+                                uint32_t EndDie, TraversalState &State) {
+  SmallVector<ScopeFrame, 16> Scopes;
+  // The unit DIE is the outermost scope.
+  Scopes.push_back({DWARFDie(), 0, 0, 0, -1ULL, 0, None, 0});
+  // The depth of a DIE whose children are not visited.
+  uint32_t SkipDepth = UINT32_MAX;
+  // Whether that DIE is a discarded function, whose variables are counted.
+  bool SkippingDiscarded = false;
+
+  // Join the variables of a function with the line table once it is left.
+  auto LeaveScope = [&]() {
+    const ScopeFrame &Left = Scopes.back();
+    if (State.Heatmap && Left.Die.getTag() == dwarf::DW_TAG_subprogram)
+      State.Heatmap->endFunction(Left.HeatmapMark, Left.Ranges,
+                                 *State.LineTable);
+    Scopes.pop_back();
+  };
+
+  auto Dies = U.dies();
+  auto Begin = Dies.begin() + std::min(FirstDie, U.getNumDIEs());
+  auto End = Dies.begin() + std::min(EndDie, U.getNumDIEs());
+  for (const DWARFDebugInfoEntry &Entry : make_range(Begin, End)) {
+    const uint32_t Depth = Entry.getDepth();
+    if (Depth > SkipDepth) {
+      // Only the tag is read within a skipped subtree.
+      const dwarf::Tag SkippedTag = Entry.getTag();
+      if (SkippingDiscarded && (SkippedTag == dwarf::DW_TAG_variable ||
+                                SkippedTag == dwarf::DW_TAG_formal_parameter))
+        ++State.Stats.DiscardedVars;
+      continue;
     }
+    SkipDepth = UINT32_MAX;
+    SkippingDiscarded = false;
+    // Leave the scopes that do not enclose this DIE.
+    while (Scopes.size() > 1 && Scopes.back().Depth >= Depth)
+      LeaveScope();
 
-    auto Ranges = RangesOrError.get();
-    uint64_t BytesInThisScope = 0;
-    for (auto Range : Ranges)
-      BytesInThisScope += Range.HighPC - Range.LowPC;
-    ScopeLowPC = getLowPC(Die);
+    DWARFDie Die(&U, &Entry);
+    const dwarf::Tag Tag = Die.getTag();
+    const ScopeFrame &Scope = Scopes.back();
+    const bool IsFunction = Tag == dwarf::DW_TAG_subprogram;
+    const bool IsBlock = Tag == dwarf::DW_TAG_lexical_block;
+    // TODO: Add a separate option to track inlined functions.
+    const bool IsInlinedFunction = Tag == dwarf::DW_TAG_inlined_subroutine;
+    if (IsFunction || IsInlinedFunction || IsBlock) {
+      LLVM_DEBUG({
+        StringRef Name = State.Names->getName(Die, DINameKind::ShortName);
+        if (!Name.empty())
+          llvm::dbgs() << "The function beeing processed is: " << Name
+                       << "\n";
+      });
 
-    LLVM_DEBUG(llvm::dbgs() << "  -the coverage: " << BytesInThisScope
-                            << " (bytes)\n");
-    BytesInScope = BytesInThisScope;
-  } else if (Die.getTag() == dwarf::DW_TAG_variable ||
-             Die.getTag() == dwarf::DW_TAG_formal_parameter) {
-    collectLocStatsForDie(Die, ScopeLowPC, BytesInScope, LocStatistics,
-                          CumulNumOfVars, TotalAverage, DICtx);
-  }
+      // Ignore forward declarations.
+      if (Die.find(dwarf::DW_AT_declaration)) {
+        LLVM_DEBUG(llvm::dbgs() << "  -declaration ignored\n");
+        SkipDepth = Depth;
+        continue;
+      }
+
+      // Ignore inlined subprograms.
+      if (Die.find(dwarf::DW_AT_inline)) {
+        LLVM_DEBUG(llvm::dbgs() << "  -inlined subprogram ignored\n");
+        SkipDepth = Depth;
+        continue;
+      }
+
+      if (IgnoreInlined && IsInlinedFunction) {
+        LLVM_DEBUG(llvm::dbgs() << "  -an inlined instance ignored\n");
+        SkipDepth = Depth;
+        continue;
+      }
+
+      // PC Ranges.
+      auto RangesOrError = getScopeRanges(Die, State.UnitArena);
+      if (!RangesOrError) {
+        llvm::consumeError(RangesOrError.takeError());
+        SkipDepth = Depth;
+        continue;
+      }
+
+      ArrayRef<DWARFAddressRange> Ranges = *RangesOrError;
+      if (IsFunction && isDiscardedFunction(Ranges, &U, State.Code)) {
+        LLVM_DEBUG(llvm::dbgs() << "  -discarded by the linker\n");
+        ++State.Stats.DiscardedFunctions;
+        SkipDepth = Depth;
+        SkippingDiscarded = true;
+        continue;
+      }
+
+      uint64_t BytesInThisScope = 0;
+      for (const auto &Range : Ranges)
+        BytesInThisScope += State.Window.getOverlap(Range.LowPC, Range.HighPC);
+      if (!State.Window.empty() && !BytesInThisScope) {
+        LLVM_DEBUG(llvm::dbgs() << "  -outside of the address window\n");
+        SkipDepth = Depth;
+        continue;
+      }
 
-  // Traverse children.
-  DWARFDie Child = Die.getFirstChild();
-  while (Child) {
-    collectStatsRecursive(Child, ScopeLowPC, BytesInScope, LocStatistics,
-                          CumulNumOfVars, TotalAverage, DICtx);
-    Child = Child.getSibling();
+      LLVM_DEBUG(llvm::dbgs() << "  -the coverage: " << BytesInThisScope
+                              << " (bytes)\n");
+      uint64_t FunctionKey = IsFunction ? getFunctionKey(Die, *State.Names)
+                                        : Scope.FunctionKey;
+      uint32_t InlineDepth =
+          IsFunction ? 0 : Scope.InlineDepth + (IsInlinedFunction ? 1 : 0);
+      size_t HeatmapMark = 0;
+      if (State.Heatmap)
+        HeatmapMark = State.Heatmap->beginFunction();
+      Scopes.push_back({Die, Depth, getLowPC(Die, Ranges), BytesInThisScope,
+                        FunctionKey, InlineDepth, Ranges, HeatmapMark});
+    } else if (Tag == dwarf::DW_TAG_variable ||
+               Tag == dwarf::DW_TAG_formal_parameter) {
+      if (Tag == dwarf::DW_TAG_formal_parameter ||
+          !collectGlobalStats(Die, Scopes.size() == 1, State))
+        collectLocStatsForDie(Die, Scopes, State);
+    } else if (Tag == dwarf::DW_TAG_call_site ||
+               Tag == dwarf::DW_TAG_GNU_call_site) {
+      // The children are the call site parameters, handled here.
+      if (State.CallSiteIndexing)
+        collectCallSiteStats(Die, State);
+      SkipDepth = Depth;
+    }
   }
+  while (Scopes.size() > 1)
+    LeaveScope();
 }
 
-static void outputLocStats(std::map<int, unsigned long> &LocStatistics,
-                           unsigned &CumulNumOfVars, double &TotalAverage,
-                           raw_ostream &OS) {
-  if (CumulNumOfVars == 0) {
-    OS << "No coverage recorded.\n";
-    return;
+static void collectUnitStats(DWARFUnit &U, uint32_t FirstDie, uint32_t EndDie,
+                             TraversalState &State) {
+  // For split DWARF, the DIEs live in the DWO unit.
+  DWARFDie CUDie;
+  {
+    locstats::TimeTraceScope TimeScope("Extract unit", U.getOffset(),
+                                       getUnitSize(U),
+                                       locstats::Phase::Extract);
+    CUDie = U.getNonSkeletonUnitDIE(false);
   }
+  if (CUDie) {
+    locstats::TimeTraceScope TimeScope("Traverse unit", U.getOffset(),
+                                       getUnitSize(U),
+                                       locstats::Phase::Traverse);
+    collectStatsForDies(*CUDie.getDwarfUnit(), FirstDie, EndDie, State);
+  }
+  if (State.Heatmap)
+    State.Heatmap->resolveFiles(*State.LineTable);
+  MaxUnitArenaBytes.updateMax(State.UnitArena.getBytesAllocated());
+  State.UnitArena.Reset();
+}
+
+/// Write the -line-heatmap rows, by file and line.
+static void outputLineHeatmap(const locstats::LineHeatmap &Heatmap,
+                              raw_ostream &OS) {
+  for (const auto &File : Heatmap.files())
+    for (const auto &Line : File.second) {
+      writeCSVField(OS, File.first);
+      OS << ',' << Line.first << ',' << Line.second.InScope << ','
+         << Line.second.Available << ',';
+      if (Line.second.InScope)
+        OS << format("%.1f",
+                     100.0 * Line.second.Available / Line.second.InScope);
+      OS << '\n';
+    }
+}
 
+/// Print the exact per-percent counts and the coverage percentiles.
+static void outputDistribution(const LocationStats &Stats, raw_ostream &OS) {
+  OS << "    cov%        samples    scope bytes\n";
+  OS << "-------------------------------------------------\n";
+  for (unsigned Percent = 0; Percent <= 100; ++Percent) {
+    uint64_t Vars = Stats.VarCoverage.getWeightForPercent(Percent);
+    if (!Vars)
+      continue;
+    OS << "    " << left_justify(std::to_string(Percent), 8)
+       << format_decimal(Vars, 11) << "    "
+       << format_decimal(Stats.ByteCoverage.getWeightForPercent(Percent), 11)
+       << "\n";
+  }
   OS << "=================================================\n";
-  OS << "           Debug Location Statistics\n";
+  auto PrintPercentiles = [&](StringRef Kind,
+                              const locstats::CoverageSketch &Sketch) {
+    OS << "-the coverage percentiles (" << Kind << "): "
+       << format("p10 %.1f%%, p50 %.1f%%, p90 %.1f%%",
+                 Sketch.getQuantile(0.1), Sketch.getQuantile(0.5),
+                 Sketch.getQuantile(0.9))
+       << "\n";
+  };
+  PrintPercentiles("by vars", Stats.VarCoverage);
+  PrintPercentiles("by scope bytes", Stats.ByteCoverage);
+  if (Stats.ScopeBytes)
+    OS << "-the covered scope bytes: " << Stats.CoveredBytes << " of "
+       << Stats.ScopeBytes << " (~ "
+       << (int)std::round(100.0 * Stats.CoveredBytes / Stats.ScopeBytes)
+       << "%)\n";
   OS << "=================================================\n";
+}
+
+/// Print the number and the share of the variables in each coverage
+/// category.
+static void outputCoverageCategories(const locstats::CoverageSketch &Coverage,
+                                     raw_ostream &OS) {
+  const uint64_t NumVars = Coverage.getTotal();
+  // Fold the per-percent counts into the coverage categories.
+  unsigned long LocStatistics[largest_cov_category] = {};
+  for (unsigned Percent = 0; Percent <= 100; ++Percent) {
+    int PercentageKey;
+    if (Percent == 0)
+      PercentageKey = 0;
+    else if (Percent == 100)
+      PercentageKey = largest_cov_category - 1;
+    else
+      PercentageKey = Percent / 10 + 1;
+    LocStatistics[PercentageKey] += Coverage.getWeightForPercent(Percent);
+  }
+
   OS << "    cov%        samples        percentage\n";
   OS << "-------------------------------------------------\n";
   OS << "    0"
      << "         " << format_decimal(LocStatistics[0], 8) << "        "
-     << format_decimal((int)(LocStatistics[0] / (double)CumulNumOfVars * 100),
-                       8)
+     << format_decimal((int)(LocStatistics[0] / (double)NumVars * 100), 8)
      << "%\n";
   OS << "    1..9"
      << "      " << format_decimal(LocStatistics[1], 8) << "        "
-     << format_decimal((int)(LocStatistics[1] / (double)CumulNumOfVars * 100),
-                       8)
+     << format_decimal((int)(LocStatistics[1] / (double)NumVars * 100), 8)
      << "%\n";
   for (unsigned i = 2; i < 11; ++i)
     OS << "    " << (i - 1) * 10 + 1 << ".." << i * 10 - 1 << "    "
        << format_decimal(LocStatistics[i], 8) << "        "
-       << format_decimal((int)(LocStatistics[i] / (double)CumulNumOfVars * 100),
-                         8)
+       << format_decimal((int)(LocStatistics[i] / (double)NumVars * 100), 8)
        << "%\n";
   OS << "    100"
      << "       " << format_decimal(LocStatistics[11], 8) << "        "
-     << format_decimal((int)(LocStatistics[11] / (double)CumulNumOfVars * 100),
-                       8)
+     << format_decimal((int)(LocStatistics[11] / (double)NumVars * 100), 8)
      << "%\n";
   OS << "=================================================\n";
+}
+
+/// Print the coverage by depth of inlining.
+static void outputInlineDepthStats(const LocationStats &Stats,
+                                   raw_ostream &OS) {
+  OS << "    depth       samples    avg cov%    bytes cov%\n";
+  OS << "-------------------------------------------------\n";
+  for (uint32_t Depth = 0; Depth < Stats.ByInlineDepth.size(); ++Depth) {
+    const InlineDepthStats &AtDepth = Stats.ByInlineDepth[Depth];
+    if (!AtDepth.Vars)
+      continue;
+    int BytesCoverage =
+        AtDepth.ScopeBytes
+            ? (int)std::round(100.0 * AtDepth.CoveredBytes / AtDepth.ScopeBytes)
+            : 0;
+    OS << "    " << left_justify(std::to_string(Depth), 8)
+       << format_decimal(AtDepth.Vars, 11) << "    "
+       << format_decimal((int)std::round(AtDepth.TotalCoverage / AtDepth.Vars),
+                         8)
+       << "%    " << format_decimal(BytesCoverage, 9) << "%\n";
+  }
+  OS << "=================================================\n";
+  for (uint32_t Depth = 0; Depth < Stats.ByInlineDepth.size(); ++Depth) {
+    const InlineDepthStats &AtDepth = Stats.ByInlineDepth[Depth];
+    if (!AtDepth.Coverage.getTotal())
+      continue;
+    OS << "-the coverage at inline depth " << Depth << ":\n";
+    outputCoverageCategories(AtDepth.Coverage, OS);
+  }
+}
+
+/// Print the statistics of the global and static variables.
+static void outputGlobalStats(const LocationStats &Stats, raw_ostream &OS) {
+  OS << "-the number of global and static variables: " << Stats.Globals
+     << "\n";
+  OS << "-with an address: " << Stats.GlobalsWithAddress << "\n";
+  OS << "-thread local: " << Stats.TLSGlobals << "\n";
+  OS << "-with a constant value: " << Stats.GlobalsWithConstValue << "\n";
+  OS << "-without a location: " << Stats.GlobalsWithoutLocation << "\n";
+  OS << "=================================================\n";
+}
+
+/// Print the call site statistics.
+static void outputCallSiteStats(const LocationStats &Stats, raw_ostream &OS) {
+  auto Percent = [](uint64_t Part, uint64_t Whole) {
+    return Whole ? (int)std::round(100.0 * Part / Whole) : 0;
+  };
+  OS << "-the number of call sites: " << Stats.CallSites << "\n";
+  OS << "-the call sites with parameters: " << Stats.CallSitesWithParams
+     << " (~ " << Percent(Stats.CallSitesWithParams, Stats.CallSites)
+     << "%)\n";
+  OS << "-the call site parameters: " << Stats.CallSiteParams << "\n";
+  OS << "-the entry value bytes: " << Stats.EntryValueBytes << "\n";
+  OS << "-the recoverable entry value bytes: "
+     << Stats.RecoverableEntryValueBytes << " (~ "
+     << Percent(Stats.RecoverableEntryValueBytes, Stats.EntryValueBytes)
+     << "%)\n";
+  OS << "=================================================\n";
+}
+
+/// Print the compaction opportunities of the location lists.
+static void outputLocCompactionStats(const LocationStats &Stats,
+                                     raw_ostream &OS) {
+  const locstats::LocCompactionStats &Compaction = Stats.LocCompaction;
+  auto Percent = [](uint64_t Part, uint64_t Whole) {
+    return Whole ? (int)std::round(100.0 * Part / Whole) : 0;
+  };
+  OS << "-the location lists decoded: " << Compaction.Lists << " ("
+     << Compaction.Entries << " entries, " << Compaction.Bytes
+     << " bytes)\n";
+  OS << "-the entries mergeable with the previous one: "
+     << Compaction.MergeableEntries << " (" << Compaction.MergeableBytes
+     << " bytes, ~ " << Percent(Compaction.MergeableBytes, Compaction.Bytes)
+     << "%)\n";
+  OS << "-the entries with an empty range: " << Compaction.EmptyEntries
+     << " (" << Compaction.EmptyBytes << " bytes, ~ "
+     << Percent(Compaction.EmptyBytes, Compaction.Bytes) << "%)\n";
+  OS << "-the lists identical to another one of their unit: "
+     << Compaction.DuplicateLists << " (" << Compaction.DuplicateBytes
+     << " bytes, ~ " << Percent(Compaction.DuplicateBytes, Compaction.Bytes)
+     << "%)\n";
+  OS << "-the size of the lists as DWARF v5 .debug_loclists: "
+     << Compaction.V5Bytes << " bytes (~ "
+     << Percent(Compaction.V5Bytes, Compaction.Bytes) << "%)\n";
+  OS << "=================================================\n";
+}
+
+/// Write the -loc-compaction row of a unit.
+static void writeLocCompactionRow(raw_ostream &OS, DWARFUnit &U,
+                                  const locstats::LocCompactionStats &Stats) {
+  OS << format("0x%08" PRIx64, U.getOffset()) << ',';
+  writeCSVField(OS, dwarf::toString(U.getUnitDIE().find(dwarf::DW_AT_name),
+                                    ""));
+  OS << ',' << Stats.Lists << ',' << Stats.Entries << ',' << Stats.Bytes
+     << ',' << Stats.MergeableEntries << ',' << Stats.MergeableBytes << ','
+     << Stats.EmptyEntries << ',' << Stats.EmptyBytes << ','
+     << Stats.DuplicateLists << ',' << Stats.DuplicateBytes << ','
+     << Stats.V5Bytes << '\n';
+}
+
+static void outputLocStats(const LocationStats &Stats, raw_ostream &OS) {
+  const unsigned long CumulNumOfVars = Stats.CumulNumOfVars;
+  const double TotalAverage = Stats.TotalAverage;
+  if (CumulNumOfVars == 0) {
+    OS << "No coverage recorded.\n";
+    return;
+  }
+
+  OS << "=================================================\n";
+  OS << "           Debug Location Statistics\n";
+  OS << "=================================================\n";
+  outputCoverageCategories(Stats.VarCoverage, OS);
   OS << "-the number of debug variables processed: " << CumulNumOfVars << "\n";
   OS << "-the average coverage per var: ~ "
      << (int)std::round((TotalAverage/CumulNumOfVars * 100) / 100) << "%\n";
+  if (Stats.DiscardedFunctions)
+    OS << "-discarded functions skipped: " << Stats.DiscardedFunctions
+       << " (with " << Stats.DiscardedVars << " variables)\n";
+  if (Stats.FrameBasedBytes)
+    OS << "-frame based location bytes without CFI: "
+       << Stats.FrameBasedBytesWithoutCFI << " of " << Stats.FrameBasedBytes
+       << "\n";
   OS << "=================================================\n";
+  if (ShowDistribution)
+    outputDistribution(Stats, OS);
+  if (ShowCallSites)
+    outputCallSiteStats(Stats, OS);
+  if (ShowInlineDepth)
+    outputInlineDepthStats(Stats, OS);
+  if (ShowGlobals)
+    outputGlobalStats(Stats, OS);
+  if (CompactionOS)
+    outputLocCompactionStats(Stats, OS);
 }
 
-static void collectLocstats(ObjectFile &Obj, DWARFContext &DICtx,
-                            Twine Filename, raw_ostream &OS) {
-  // Map percentage->occurrences.
-  std::map<int, unsigned long> LocStatistics;
-  for (int i = 0; i < largest_cov_category; ++i)
-    LocStatistics[i] = 0;
+/// Collect the executable sections of a linked binary.
+static AddressWindow getCodeRanges(const ObjectFile &Obj) {
+  AddressWindow Code;
+  if (Obj.isRelocatableObject())
+    return Code;
+  for (const SectionRef &Section : Obj.sections())
+    if (Section.isText())
+      Code.addRange(Section.getAddress(),
+                    Section.getAddress() + Section.getSize());
+  Code.finalize();
+  return Code;
+}
 
-  unsigned CumulNumOfVars = 0;
-  double TotalAverage = 0.0;
-  
-  for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units())
-    if (DWARFDie CUDie = CU->getNonSkeletonUnitDIE(false))
-      collectStatsRecursive(CUDie, 0, 0, LocStatistics, CumulNumOfVars,
-                            TotalAverage, DICtx);
+/// Print the data symbols of a linked binary whose address no global variable
+/// has. Both sides are sorted by address and joined in a single pass.
+static void checkGlobalsAgainstSymbols(const ObjectFile &Obj,
+                                       std::vector<uint64_t> &Addresses,
+                                       raw_ostream &OS) {
+  std::vector<std::pair<uint64_t, StringRef>> Symbols;
+  for (const SymbolRef &Symbol : Obj.symbols()) {
+    if (Symbol.getFlags() & SymbolRef::SF_Undefined)
+      continue;
+    Expected<SymbolRef::Type> Type = Symbol.getType();
+    Expected<uint64_t> Address = Symbol.getAddress();
+    Expected<StringRef> Name = Symbol.getName();
+    if (!Type || !Address || !Name) {
+      consumeError(Type.takeError());
+      consumeError(Address.takeError());
+      consumeError(Name.takeError());
+      continue;
+    }
+    // The address of a thread local symbol is an offset in the TLS block.
+    if (*Type != SymbolRef::ST_Data ||
+        (Obj.isELF() && ELFSymbolRef(Symbol).getELFType() == ELF::STT_TLS))
+      continue;
+    Symbols.push_back({*Address, *Name});
+  }
+  llvm::sort(Symbols);
+  llvm::sort(Addresses);
+
+  std::vector<std::pair<uint64_t, StringRef>> Missing;
+  auto Addr = Addresses.begin();
+  for (const auto &Symbol : Symbols) {
+    while (Addr != Addresses.end() && *Addr < Symbol.first)
+      ++Addr;
+    if (Addr == Addresses.end() || *Addr != Symbol.first)
+      Missing.push_back(Symbol);
+  }
+
+  OS << "-data symbols without debug info: " << Missing.size() << " of "
+     << Symbols.size() << "\n";
+  for (const auto &Symbol : Missing)
+    OS << "    " << format_hex(Symbol.first, 18) << " " << Symbol.second
+       << "\n";
+  OS << "=================================================\n";
+}
+
+/// Collect the address ranges described by the FDEs of .eh_frame and
+/// .debug_frame into one sorted index.
+static AddressWindow getUnwindRanges(DWARFContext &DICtx) {
+  AddressWindow Unwind;
+  for (const DWARFDebugFrame *Frames :
+       {DICtx.getEHFrame(), DICtx.getDebugFrame()}) {
+    if (!Frames)
+      continue;
+    for (const dwarf::FrameEntry &Entry : Frames->entries())
+      if (const auto *FDE = dyn_cast<dwarf::FDE>(&Entry))
+        Unwind.addRange(FDE->getInitialLocation(),
+                        FDE->getInitialLocation() + FDE->getAddressRange());
+  }
+  Unwind.finalize();
+  return Unwind;
+}
+
+/// Parse the -address-range values.
+static AddressWindow parseAddressRanges() {
+  AddressWindow Window;
+  for (StringRef Arg : AddressRanges) {
+    StringRef Lo, Hi;
+    std::tie(Lo, Hi) = Arg.split('-');
+    uint64_t LowPC, HighPC;
+    if (Lo.trim().getAsInteger(0, LowPC) || Hi.trim().getAsInteger(0, HighPC) ||
+        LowPC >= HighPC) {
+      WithColor::error() << "invalid address range '" << Arg
+                         << "', expected <lo>-<hi> with <lo> < <hi>\n";
+      exit(1);
+    }
+    Window.addRange(LowPC, HighPC);
+  }
+  Window.finalize();
+  return Window;
+}
+
+static void error(StringRef Prefix, std::error_code EC);
+
+/// Add the statistics saved by -save-stats in \p Filename.
+static void mergeSavedStats(StringRef Filename, GroupedStats &Stats) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+      MemoryBuffer::getFileOrSTDIN(Filename);
+  error(Filename, BuffOrErr.getError());
+  Expected<json::Value> V = json::parse((*BuffOrErr)->getBuffer());
+  if (!V) {
+    WithColor::error() << Filename << ": " << toString(V.takeError()) << "\n";
+    exit(1);
+  }
+  const json::Object *O = V->getAsObject();
+  const json::Object *Groups = O ? O->getObject("groups") : nullptr;
+  llvm::Optional<int64_t> Version = O ? O->getInteger("version") : None;
+  bool Valid = Version && *Version == 1 && Groups;
+  if (Valid)
+    for (const auto &Group : *Groups)
+      Valid &= Stats[Group.first.str()].fromJSON(Group.second);
+  if (!Valid) {
+    WithColor::error() << Filename << ": malformed location statistics\n";
+    exit(1);
+  }
+}
+
+/// Write the statistics in a form that -merge-stats can read back.
+static void saveStats(const GroupedStats &Stats) {
+  json::Object Groups;
+  for (const auto &Group : Stats)
+    Groups[Group.first] = Group.second.toJSON();
+  std::error_code EC;
+  ToolOutputFile Out(SaveStats, EC, sys::fs::OF_Text);
+  error("Unable to open " + SaveStats, EC);
+  Out.os() << formatv("{0:2}",
+                      json::Value(json::Object{{"version", 1},
+                                               {"groups", std::move(Groups)}}))
+           << "\n";
+  Out.keep();
+}
+
+/// Merge in the -merge-stats inputs, save and print the statistics.
+static void reportLocStats(GroupedStats &Stats, raw_ostream &OS) {
+  for (const std::string &Filename : MergeStats)
+    mergeSavedStats(Filename, Stats);
+
+  if (!SaveStats.empty())
+    saveStats(Stats);
+
+  if (Stats.empty()) {
+    outputLocStats(LocationStats(), OS);
+    return;
+  }
+
+  for (const auto &Group : Stats) {
+    if (GroupBy != GroupKind::None || Stats.size() > 1)
+      OS << "Group: " << Group.first << "\n";
+    outputLocStats(Group.second, OS);
+  }
+}
+
+/// Return the opt level flag recorded in a producer string, e.g. "-O2".
+static StringRef getOptLevel(StringRef Producer) {
+  StringRef OptLevel = "<no -O flag>";
+  SmallVector<StringRef, 16> Flags;
+  Producer.split(Flags, ' ', -1, /*KeepEmpty=*/false);
+  // The last one wins, as it does on the command line.
+  for (StringRef Flag : Flags)
+    if (Flag.startswith("-O"))
+      OptLevel = Flag;
+  return OptLevel;
+}
+
+/// Return the -group-by key of a unit. Only the unit DIE is extracted.
+static std::string getGroupKey(DWARFUnit &U) {
+  if (GroupBy == GroupKind::None)
+    return std::string();
+  DWARFDie CUDie = U.getNonSkeletonUnitDIE(/*ExtractUnitDIEOnly=*/true);
+  StringRef Producer = dwarf::toStringRef(CUDie.find(dwarf::DW_AT_producer));
+  if (GroupBy == GroupKind::OptLevel)
+    return getOptLevel(Producer);
+  if (Producer.empty())
+    return "<unknown producer>";
+  return Producer;
+}
+
+/// Split the units of more than -split-unit-dies DIEs into parts starting at
+/// children of the unit DIE, such as the functions, so that the threads also
+/// share the work of the largest units, like those of an LTO build. The scope
+/// stack is empty between the children, so the parts are traversed
+/// independently. They are combined in order, like the units, and the
+/// statistics are sums, so the results do not depend on the split. The DIEs
+/// must have been extracted.
+static std::vector<UnitResult> splitUnits(std::vector<UnitResult> &Units) {
+  std::vector<UnitResult> Parts;
+  for (UnitResult &Result : Units) {
+    uint32_t PartBegin = 0;
+    DWARFDie CUDie = Result.Unit->getNonSkeletonUnitDIE(false);
+    DWARFUnit *U = CUDie ? CUDie.getDwarfUnit() : nullptr;
+    if (U && SplitUnitDies && U->getNumDIEs() > SplitUnitDies) {
+      uint32_t Index = 0;
+      for (const DWARFDebugInfoEntry &Entry : U->dies()) {
+        if (Entry.getDepth() == 1 && Index - PartBegin >= SplitUnitDies) {
+          Parts.emplace_back(Result.Unit, Result.GroupStats, PartBegin, Index);
+          PartBegin = Index;
+        }
+        ++Index;
+      }
+    }
+    Parts.emplace_back(Result.Unit, Result.GroupStats, PartBegin);
+  }
+  return Parts;
+}
+
+void locstats::collectLocstats(ObjectFile &Obj, DWARFContext &DICtx,
+                               Twine Filename, raw_ostream &OS) {
+  // Select the units overlapping the address window by their aranges, so
+  // that the DIEs of the other units are only extracted if referred to.
+  AddressWindow Window = parseAddressRanges();
+  AddressWindow Code = getCodeRanges(Obj);
+  // The call frame information is parsed once, before any thread starts.
+  AddressWindow Unwind;
+  if (CFIAware) {
+    Unwind = getUnwindRanges(DICtx);
+    if (Unwind.empty())
+      WithColor::warning() << Filename
+                           << ": no call frame information, -cfi-aware "
+                              "ignored\n";
+  }
+  DenseSet<uint64_t> SelectedUnits;
+  if (!Window.empty())
+    for (const auto &R : Window.ranges())
+      DICtx.getDebugAranges()->findAddressRange(R.LowPC, R.HighPC,
+                                                SelectedUnits);
+
+  // Assign the units to their groups first, reading only the unit DIEs.
+  GroupedStats Stats;
+  std::vector<UnitResult> Units;
+  for (const auto &CU : static_cast<DWARFContext *>(&DICtx)->compile_units()) {
+    if (!Window.empty() && !SelectedUnits.count(CU->getOffset()))
+      continue;
+    Units.emplace_back(CU.get(), &Stats[getGroupKey(*CU)]);
+  }
+
+  // The units are traversed independently. As soon as a prefix of them is
+  // done, its results are combined and its -dump-vars rows are written out,
+  // so that both happen in unit order whatever the number of threads.
+  std::mutex OutputMutex;
+  size_t NextToWrite = 0;
+  locstats::LineHeatmap Heatmap;
+  // The line tables are parsed by the threads traversing their units.
+  locstats::LineTableCache LineTables;
+  locstats::DieNameCache Names;
+  // The parts of a split unit may share location lists, so the lists of a
+  // unit are summarized once all of its parts are combined.
+  DWARFUnit *CompactionUnit = nullptr;
+  LocationStats *CompactionGroup = nullptr;
+  locstats::LocListCompaction UnitCompaction;
+  auto FlushCompaction = [&] {
+    if (UnitCompaction.empty())
+      return;
+    locstats::LocCompactionStats UnitStats = UnitCompaction.summarize();
+    writeLocCompactionRow(*CompactionOS, *CompactionUnit, UnitStats);
+    CompactionGroup->LocCompaction.merge(UnitStats);
+    UnitCompaction = locstats::LocListCompaction();
+  };
+  auto TraverseUnit = [&](UnitResult &Result) {
+    TraversalState State(Result.Stats, *Result.GroupStats, Result.CallSites,
+                         Window);
+    State.Names = &Names;
+    // The call site statistics are printed by -call-sites and saved by
+    // -save-stats. The entry values are also needed by -ignore-entry-values
+    // and by the entry_value column of -dump-vars.
+    State.CallSiteIndexing = ShowCallSites || !SaveStats.empty();
+    State.EntryValues =
+        State.CallSiteIndexing || IgnoreEntryValues || VarDumpOS;
+    if (!Code.empty())
+      State.Code = &Code;
+    if (!Unwind.empty())
+      State.Unwind = &Unwind;
+    if (ShowGlobals)
+      State.GlobalAddresses = &Result.GlobalAddresses;
+    if (CompactionOS)
+      State.Compaction = &Result.Compaction;
+    // The -dump-vars rows of the part next in order, such as every unit when
+    // running serially, are written out directly. The others are buffered.
+    raw_string_ostream VarRows(Result.VarRows);
+    if (VarDumpOS) {
+      std::lock_guard<std::mutex> Lock(OutputMutex);
+      State.VarRows = &Units[NextToWrite] == &Result ? VarDumpOS : &VarRows;
+    }
+    if (HeatmapOS) {
+      locstats::TimeTraceScope TimeScope("Parse line table",
+                                         Result.Unit->getOffset(),
+                                         getUnitSize(*Result.Unit));
+      State.LineTable = LineTables.get(*Result.Unit);
+      if (State.LineTable)
+        State.Heatmap = &Result.Heatmap;
+    }
+    collectUnitStats(*Result.Unit, Result.FirstDie, Result.EndDie, State);
+    VarRows.flush();
+
+    std::lock_guard<std::mutex> Lock(OutputMutex);
+    Result.Done = true;
+    for (; NextToWrite < Units.size() && Units[NextToWrite].Done;
+         ++NextToWrite) {
+      UnitResult &Next = Units[NextToWrite];
+      Next.GroupStats->merge(Next.Stats);
+      Next.Stats = LocationStats();
+      if (VarDumpOS)
+        *VarDumpOS << Next.VarRows;
+      std::string().swap(Next.VarRows);
+      Heatmap.merge(Next.Heatmap);
+      Next.Heatmap = locstats::LineHeatmap();
+      if (CompactionOS) {
+        if (Next.Unit != CompactionUnit) {
+          FlushCompaction();
+          CompactionUnit = Next.Unit;
+          CompactionGroup = Next.GroupStats;
+        }
+        if (UnitCompaction.empty())
+          UnitCompaction = std::move(Next.Compaction);
+        else
+          UnitCompaction.merge(Next.Compaction);
+        Next.Compaction = locstats::LocListCompaction();
+      }
+    }
+  };
+
+  if (NumThreads == 1 || Units.empty()) {
+    for (UnitResult &Result : Units)
+      TraverseUnit(Result);
+  } else {
+    ThreadPool Pool(NumThreads ? NumThreads
+                               : std::thread::hardware_concurrency());
+    // The DWARF parser is not thread-safe, so extract the units to traverse
+    // before the threads only read them. The units outside -address-range
+    // are only extracted if a cross-unit reference reaches them, under the
+    // lock of DieNameCache::getReferencedDie(). The DIEs of the largest
+    // units are decoded in segments on the pool.
+    for (UnitResult &Result : Units) {
+      DWARFUnit *CU = Result.Unit;
+      locstats::TimeTraceScope TimeScope("Extract unit", CU->getOffset(),
+                                         getUnitSize(*CU),
+                                         locstats::Phase::Extract);
+      DWARFDie UnitDie = CU->getNonSkeletonUnitDIE(true);
+      if (UnitDie && getUnitSize(*UnitDie.getDwarfUnit()) >=
+                         2 * ExtractSegmentSize)
+        UnitDie.getDwarfUnit()->extractDIEsInParallel(Pool,
+                                                      ExtractSegmentSize);
+      CU->getNonSkeletonUnitDIE(false);
+      // The base address is cached on first use, and the parts of a split
+      // unit decoding its location and range lists would race to do it.
+      CU->getBaseAddress();
+      if (UnitDie)
+        UnitDie.getDwarfUnit()->getBaseAddress();
+    }
+    Units = splitUnits(Units);
+    for (UnitResult &Result : Units)
+      Pool.async(TraverseUnit, std::ref(Result));
+    Pool.wait();
+  }
+  if (CompactionOS)
+    FlushCompaction();
+
+  // Call sites may precede their callees, or live in other units.
+  CallSiteIndex CallSites;
+  for (UnitResult &Result : Units) {
+    CallSites.DescribedParams.insert(Result.CallSites.DescribedParams.begin(),
+                                     Result.CallSites.DescribedParams.end());
+    CallSites.EntryValues.insert(CallSites.EntryValues.end(),
+                                 Result.CallSites.EntryValues.begin(),
+                                 Result.CallSites.EntryValues.end());
+  }
+  CallSites.resolve();
 
   // Output the results.
-  outputLocStats(LocStatistics, CumulNumOfVars, TotalAverage, OS);
+  locstats::TimeTraceScope TimeScope("Report", StringRef(),
+                                     locstats::Phase::Report);
+  if (HeatmapOS)
+    outputLineHeatmap(Heatmap, *HeatmapOS);
+  reportLocStats(Stats, OS);
+
+  // The addresses of a relocatable object are section relative.
+  if (ShowGlobals && !Obj.isRelocatableObject()) {
+    std::vector<uint64_t> GlobalAddresses;
+    for (UnitResult &Result : Units)
+      GlobalAddresses.insert(GlobalAddresses.end(),
+                             Result.GlobalAddresses.begin(),
+                             Result.GlobalAddresses.end());
+    checkGlobalsAgainstSymbols(Obj, GlobalAddresses, OS);
+  }
 }
 
 static void error(StringRef Prefix, std::error_code EC) {
@@ -314,32 +1957,77 @@ static void error(StringRef Prefix, std::error_code EC) {
   exit(1);
 }
 
+/// Load the debug sections of \p Obj, which also decompresses them.
+static std::unique_ptr<DWARFContext> createDWARFContext(const ObjectFile &Obj,
+                                                        StringRef Filename) {
+  locstats::TimeTraceScope TimeScope("Load debug sections", Filename,
+                                     locstats::Phase::Load);
+  return DWARFContext::create(Obj);
+}
+
+/// Look up the separate debug file of a stripped binary and run the handler
+/// on it. Returns false if no debug file was found.
+static bool handleSeparateDebugFile(ObjectFile &Obj, StringRef Filename,
+                                    HandlerFn HandleObj, raw_ostream &OS) {
+  locstats::DebugFileLookup Lookup(DebugFileDirectories, DebugFileIndex,
+                                  RescanDebugFileIndex);
+  llvm::Optional<std::string> DebugPath = Lookup.find(Obj, Filename);
+  if (Error E = Lookup.saveIndex())
+    WithColor::warning() << "unable to write " << DebugFileIndex << ": "
+                         << toString(std::move(E)) << "\n";
+  if (!DebugPath)
+    return false;
+  LLVM_DEBUG(llvm::dbgs() << "Using debug file " << *DebugPath << "\n");
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+      MemoryBuffer::getFile(*DebugPath);
+  error(*DebugPath, BuffOrErr.getError());
+  Expected<std::unique_ptr<Binary>> BinOrErr =
+      object::createBinary(**BuffOrErr);
+  error(*DebugPath, errorToErrorCode(BinOrErr.takeError()));
+
+  auto *DebugObj = dyn_cast<ObjectFile>(BinOrErr->get());
+  if (!DebugObj)
+    return false;
+  std::unique_ptr<DWARFContext> DICtx =
+      createDWARFContext(*DebugObj, *DebugPath);
+  HandleObj(*DebugObj, *DICtx, *DebugPath, OS);
+  return true;
+}
+
 static void handleBuffer(StringRef Filename, MemoryBufferRef Buffer,
                          HandlerFn HandleObj, raw_ostream &OS) {
   Expected<std::unique_ptr<Binary>> BinOrErr = object::createBinary(Buffer);
   error(Filename, errorToErrorCode(BinOrErr.takeError()));
 
   if (auto *Obj = dyn_cast<ObjectFile>(BinOrErr->get())) {
-    std::unique_ptr<DWARFContext> DICtx = DWARFContext::create(*Obj);
+    // Stripped binaries keep their DWARF in a separate debug file.
+    if (!locstats::hasDebugInfo(*Obj) &&
+        handleSeparateDebugFile(*Obj, Filename, HandleObj, OS))
+      return;
+    std::unique_ptr<DWARFContext> DICtx = createDWARFContext(*Obj, Filename);
     HandleObj(*Obj, *DICtx, Filename, OS);
   }
 }
 
 static void handleFile(StringRef Filename, HandlerFn HandleObj,
                        raw_ostream &OS) {
-  ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
-  MemoryBuffer::getFileOrSTDIN(Filename);
-  error(Filename, BuffOrErr.getError());
-  std::unique_ptr<MemoryBuffer> Buffer = std::move(BuffOrErr.get());
+  std::unique_ptr<MemoryBuffer> Buffer;
+  {
+    locstats::TimeTraceScope TimeScope("Load file", Filename,
+                                       locstats::Phase::Load);
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BuffOrErr =
+        MemoryBuffer::getFileOrSTDIN(Filename);
+    error(Filename, BuffOrErr.getError());
+    Buffer = std::move(BuffOrErr.get());
+  }
   handleBuffer(Filename, *Buffer, HandleObj, OS);
 }
 
-int main(int argc, char **argv) {
-  InitLLVM X(argc, argv);
-
-  llvm::InitializeAllTargetInfos();
-  llvm::InitializeAllTargetMCs();
-
+int locstats::runLocStats(int argc, char **argv) {
+  // No target is initialized, nor is the DWARFContext given register info:
+  // the statistics only decode the location expressions, never print them,
+  // and registering every target dominated the run time on small inputs.
   HideUnrelatedOptions({&LocStatsCategory});
   cl::ParseCommandLineOptions(
       argc, argv,
@@ -350,7 +2038,7 @@ int main(int argc, char **argv) {
     return 0;
   }
 
-  if (InputFilename == "") {
+  if (InputFilename == "" && MergeStats.empty()) {
     WithColor::error(errs()) << "no input file\n";
     exit(1);
   }
@@ -368,7 +2056,75 @@ int main(int argc, char **argv) {
   // Don't remove output file if we exit with an error.
   OutputFile.keep();
 
-  handleFile(InputFilename, collectLocstats, OutputFile.os());
+  std::unique_ptr<ToolOutputFile> VarDumpFile;
+  if (!DumpVars.empty()) {
+    VarDumpFile =
+        llvm::make_unique<ToolOutputFile>(DumpVars, EC, sys::fs::OF_Text);
+    error("Unable to open " + DumpVars, EC);
+    VarDumpFile->keep();
+    VarDumpOS = &VarDumpFile->os();
+    *VarDumpOS << "cu_offset,cu_name,function,inline_chain,name,tag,"
+                  "scope_bytes,covered_bytes,const_value,entry_value\n";
+  }
+
+  std::unique_ptr<ToolOutputFile> HeatmapFile;
+  if (!LineHeatmapFile.empty()) {
+    HeatmapFile = llvm::make_unique<ToolOutputFile>(LineHeatmapFile, EC,
+                                                    sys::fs::OF_Text);
+    error("Unable to open " + LineHeatmapFile, EC);
+    HeatmapFile->keep();
+    HeatmapOS = &HeatmapFile->os();
+    *HeatmapOS << "file,line,in_scope,with_location,availability\n";
+  }
+
+  std::unique_ptr<ToolOutputFile> CompactionFile;
+  if (!LocCompactionFile.empty()) {
+    CompactionFile = llvm::make_unique<ToolOutputFile>(LocCompactionFile, EC,
+                                                       sys::fs::OF_Text);
+    error("Unable to open " + LocCompactionFile, EC);
+    CompactionFile->keep();
+    CompactionOS = &CompactionFile->os();
+    *CompactionOS << "cu_offset,cu_name,lists,entries,bytes,"
+                     "mergeable_entries,mergeable_bytes,empty_entries,"
+                     "empty_bytes,duplicate_lists,duplicate_bytes,v5_bytes\n";
+  }
+
+  std::unique_ptr<locstats::TimeTrace> Trace;
+  if (!TimeTraceFile.empty()) {
+    Trace = llvm::make_unique<locstats::TimeTrace>(TimeTraceGranularity);
+    locstats::TimeTraceInstance = Trace.get();
+  }
+
+  locstats::PhaseCounters Phases;
+  if (ShowPerfCounters) {
+    std::string Reason;
+    if (!locstats::enablePerfCounters(Reason))
+      WithColor::warning() << "hardware performance counters are "
+                              "unavailable (" << Reason
+                           << "), only the times are reported\n";
+    locstats::PhaseCountersInstance = &Phases;
+  }
+
+  if (InputFilename == "") {
+    // Only combine previously saved statistics.
+    GroupedStats Stats;
+    reportLocStats(Stats, OutputFile.os());
+  } else
+    handleFile(InputFilename, locstats::collectLocstats, OutputFile.os());
+
+  if (ShowPerfCounters) {
+    locstats::PhaseCountersInstance = nullptr;
+    locstats::disablePerfCounters();
+    Phases.print(OutputFile.os());
+  }
+
+  if (Trace) {
+    locstats::TimeTraceInstance = nullptr;
+    ToolOutputFile TraceFile(TimeTraceFile, EC, sys::fs::OF_Text);
+    error("Unable to open " + TimeTraceFile, EC);
+    Trace->write(TraceFile.os());
+    TraceFile.keep();
+  }
  
   return EXIT_SUCCESS;
 }
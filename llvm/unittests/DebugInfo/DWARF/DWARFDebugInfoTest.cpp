@@ -29,6 +29,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/TargetRegistry.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 #include <string>
@@ -3158,4 +3159,191 @@ TEST(DWARFDebugInfo, TestDWARFDieRangeInfoIntersects) {
   AssertRangesIntersect(Ranges, {{0x20, 0x21}, {0x2f, 0x31}});
 }
 
+TEST(DWARFDebugInfo, TestAbbreviationSkipProgram) {
+  // A variable with fixed size attributes around an exprloc location, and a
+  // trailing string.
+  const uint8_t AbbrevData[] = {
+      0x01,       // Abbreviation code.
+      0x34, 0x00, // DW_TAG_variable, no children.
+      0x3a, 0x0b, // DW_AT_decl_file, DW_FORM_data1.
+      0x49, 0x10, // DW_AT_type, DW_FORM_ref_addr.
+      0x3f, 0x19, // DW_AT_external, DW_FORM_flag_present.
+      0x02, 0x18, // DW_AT_location, DW_FORM_exprloc.
+      0x11, 0x01, // DW_AT_low_pc, DW_FORM_addr.
+      0x12, 0x07, // DW_AT_high_pc, DW_FORM_data8.
+      0x03, 0x08, // DW_AT_name, DW_FORM_string.
+      0x00, 0x00};
+  DataExtractor Data(StringRef(reinterpret_cast<const char *>(AbbrevData),
+                               sizeof(AbbrevData)),
+                     true, 8);
+  uint32_t Offset = 0;
+  DWARFAbbreviationDeclaration Abbrev;
+  ASSERT_TRUE(Abbrev.extract(Data, &Offset));
+
+  using SkipStep = DWARFAbbreviationDeclaration::SkipStep;
+  std::vector<SkipStep> Program;
+  Abbrev.appendSkipProgram({4, 8, DWARF32}, Program);
+  ASSERT_EQ(Program.size(), 3u);
+  EXPECT_EQ(Program[0].FixedBytes, 5u);
+  EXPECT_EQ(Program[0].Kind, SkipStep::BlockULEB128);
+  EXPECT_EQ(Program[1].FixedBytes, 16u);
+  EXPECT_EQ(Program[1].Kind, SkipStep::CString);
+  EXPECT_EQ(Program[2].FixedBytes, 0u);
+  EXPECT_EQ(Program[2].Kind, SkipStep::End);
+
+  // In DWARF v2, DW_FORM_ref_addr has the size of an address.
+  Program.clear();
+  Abbrev.appendSkipProgram({2, 4, DWARF32}, Program);
+  ASSERT_EQ(Program.size(), 3u);
+  EXPECT_EQ(Program[0].FixedBytes, 5u);
+  EXPECT_EQ(Program[1].FixedBytes, 12u);
+}
+
+void TestExtractDIEsInParallel(bool WithBadSibling) {
+  Triple Triple = getNormalizedDefaultTargetTriple();
+  if (!isConfigurationSupported(Triple))
+    return;
+
+  uint16_t Version = 4;
+  auto ExpectedDG = dwarfgen::Generator::create(Triple, Version);
+  ASSERT_THAT_EXPECTED(ExpectedDG, Succeeded());
+  dwarfgen::Generator *DG = ExpectedDG.get().get();
+  dwarfgen::CompileUnit &CU = DG->addCompileUnit();
+
+  {
+    // Create DWARF tree that looks like:
+    //
+    // CU
+    //   subprogram (with a DW_AT_sibling on every other one)
+    //     lexical_block
+    //       variable
+    //     formal_parameter
+    //   ...
+    //   base_type
+    auto CUDie = CU.getUnitDIE();
+    CUDie.addAttribute(DW_AT_name, DW_FORM_strp, "/tmp/main.c");
+    std::vector<dwarfgen::DIE> Subprograms;
+    std::vector<dwarfgen::DIE> Variables;
+    for (unsigned I = 0; I < 8; ++I) {
+      dwarfgen::DIE Subprogram = CUDie.addChild(DW_TAG_subprogram);
+      Subprogram.addAttribute(DW_AT_name, DW_FORM_string, "f");
+      dwarfgen::DIE Block = Subprogram.addChild(DW_TAG_lexical_block);
+      Variables.push_back(Block.addChild(DW_TAG_variable));
+      Variables.back().addAttribute(DW_AT_name, DW_FORM_string, "v");
+      Subprogram.addChild(DW_TAG_formal_parameter);
+      Subprograms.push_back(Subprogram);
+    }
+    dwarfgen::DIE Type = CUDie.addChild(DW_TAG_base_type);
+    for (unsigned I = 0; I < Subprograms.size(); I += 2)
+      Subprograms[I].addAttribute(DW_AT_sibling, DW_FORM_ref4,
+                                  Subprograms[I + 1]);
+    // A sibling pointing within the subtree makes the segments inconsistent.
+    Subprograms[1].addAttribute(DW_AT_sibling, DW_FORM_ref4,
+                                WithBadSibling ? Variables[1] : Subprograms[2]);
+    Subprograms.back().addAttribute(DW_AT_sibling, DW_FORM_ref4, Type);
+  }
+
+  MemoryBufferRef FileBuffer(DG->generate(), "dwarf");
+  auto Obj = object::ObjectFile::createObjectFile(FileBuffer);
+  ASSERT_TRUE((bool)Obj);
+  std::unique_ptr<DWARFContext> SerialContext = DWARFContext::create(**Obj);
+  std::unique_ptr<DWARFContext> ParallelContext = DWARFContext::create(**Obj);
+  DWARFUnit *SerialU = SerialContext->getUnitAtIndex(0);
+  DWARFUnit *ParallelU = ParallelContext->getUnitAtIndex(0);
+
+  // With one byte segments, each child of the unit DIE is a segment.
+  ThreadPool Pool(4);
+  EXPECT_EQ(ParallelU->extractDIEsInParallel(Pool, 1),
+            SerialU->getNumDIEs());
+  ASSERT_EQ(ParallelU->getNumDIEs(), SerialU->getNumDIEs());
+  for (unsigned I = 0; I < SerialU->getNumDIEs(); ++I) {
+    const DWARFDebugInfoEntry *Serial =
+        SerialU->getDIEAtIndex(I).getDebugInfoEntry();
+    const DWARFDebugInfoEntry *Parallel =
+        ParallelU->getDIEAtIndex(I).getDebugInfoEntry();
+    EXPECT_EQ(Parallel->getOffset(), Serial->getOffset());
+    EXPECT_EQ(Parallel->getDepth(), Serial->getDepth());
+    EXPECT_EQ(Parallel->getTag(), Serial->getTag());
+  }
+}
+
+TEST(DWARFDebugInfo, TestExtractDIEsInParallel) {
+  TestExtractDIEsInParallel(/*WithBadSibling=*/false);
+}
+
+TEST(DWARFDebugInfo, TestExtractDIEsInParallelWithBadSibling) {
+  TestExtractDIEsInParallel(/*WithBadSibling=*/true);
+}
+
+TEST(DWARFDebugInfo, TestDeeplyNestedUnit) {
+  // A subprogram holding a chain of lexical blocks, one per level, with a
+  // variable in the innermost one. The unit is generated from YAML, which
+  // lists the DIEs flat, as dwarfgen emits them recursively.
+  const uint32_t MaxDepth = 50000;
+  std::string yamldata = R"(
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_yes
+        Attributes:
+      - Code:            0x00000003
+        Tag:             DW_TAG_lexical_block
+        Children:        DW_CHILDREN_yes
+        Attributes:
+      - Code:            0x00000004
+        Tag:             DW_TAG_variable
+        Children:        DW_CHILDREN_no
+        Attributes:
+    debug_info:
+      - Length:
+          TotalLength:     0
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+          - AbbrCode:        0x00000002
+            Values:
+)";
+  for (uint32_t Depth = 2; Depth < MaxDepth; ++Depth)
+    yamldata += "          - AbbrCode:        0x00000003\n"
+                "            Values:\n";
+  yamldata += "          - AbbrCode:        0x00000004\n"
+              "            Values:\n";
+  // Close all the scopes but the variable.
+  for (uint32_t Depth = 0; Depth < MaxDepth; ++Depth)
+    yamldata += "          - AbbrCode:        0x00000000\n"
+                "            Values:\n";
+
+  auto ErrOrSections = DWARFYAML::EmitDebugSections(yamldata, true);
+  ASSERT_TRUE((bool)ErrOrSections);
+  std::unique_ptr<DWARFContext> DwarfContext =
+      DWARFContext::create(*ErrOrSections, 8);
+  DWARFUnit *U = DwarfContext->getUnitAtIndex(0);
+
+  // The unit DIE, one DIE per level, and a NULL entry closing all but the
+  // variable.
+  DWARFDie Die = U->getUnitDIE(false);
+  ASSERT_TRUE(Die.isValid());
+  EXPECT_EQ(U->getNumDIEs(), 2 * MaxDepth + 1);
+
+  // Walk down to the variable and back up to the unit DIE.
+  for (uint32_t Depth = 1; Depth <= MaxDepth; ++Depth) {
+    Die = Die.getFirstChild();
+    ASSERT_TRUE(Die.isValid());
+    ASSERT_EQ(Die.getDebugInfoEntry()->getDepth(), Depth);
+  }
+  EXPECT_EQ(Die.getTag(), DW_TAG_variable);
+  for (uint32_t Depth = MaxDepth; Depth > 0; --Depth) {
+    Die = Die.getParent();
+    ASSERT_TRUE(Die.isValid());
+  }
+  EXPECT_EQ(Die.getTag(), DW_TAG_compile_unit);
+}
+
 } // end anonymous namespace
@@ -116,4 +116,44 @@ TEST(DataExtractorTest, LEB128) {
   EXPECT_EQ(8U, offset);
 }
 
+TEST(DataExtractorTest, Offsets64) {
+  DataExtractor DE(StringRef(numberData, sizeof(numberData)-1), false, 8);
+  uint64_t offset = 0;
+
+  EXPECT_EQ(0x8090U, DE.getU16(&offset));
+  EXPECT_EQ(2U, offset);
+  EXPECT_EQ(0xFFFF8000U, DE.getU32(&offset));
+  EXPECT_EQ(6U, offset);
+  offset = 0;
+  EXPECT_EQ(0x8090FFFF80000000ULL, DE.getAddress(&offset));
+  EXPECT_EQ(8U, offset);
+
+  // Reading past the end leaves the offset unchanged.
+  EXPECT_EQ(0U, DE.getU8(&offset));
+  EXPECT_EQ(8U, offset);
+
+  // An offset beyond 4 GiB is not truncated to one within the data.
+  offset = (1ULL << 32) + 2;
+  EXPECT_FALSE(DE.isValidOffset(offset));
+  EXPECT_FALSE(DE.isValidOffsetForDataOfSize(offset, 2));
+  EXPECT_EQ(0U, DE.getU16(&offset));
+  EXPECT_EQ((1ULL << 32) + 2, offset);
+  EXPECT_EQ(nullptr, DE.getCStr(&offset));
+
+  DataExtractor SDE(StringRef(stringData, sizeof(stringData)-1), false, 8);
+  offset = 0;
+  EXPECT_EQ(stringData, SDE.getCStr(&offset));
+  EXPECT_EQ(11U, offset);
+  EXPECT_EQ("", SDE.getCStrRef(&offset));
+  EXPECT_EQ(11U, offset);
+
+  DataExtractor LDE(StringRef(leb128data, sizeof(leb128data)-1), false, 8);
+  offset = 0;
+  EXPECT_EQ(9382ULL, LDE.getULEB128(&offset));
+  EXPECT_EQ(2U, offset);
+  offset = 0;
+  EXPECT_EQ(-7002LL, LDE.getSLEB128(&offset));
+  EXPECT_EQ(2U, offset);
+}
+
 }
@@ -0,0 +1,191 @@
+//===-- CompactLineTableTest.cpp --------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "CompactLineTable.h"
+#include "llvm/ADT/STLExtras.h"
+#include "gtest/gtest.h"
+#include <tuple>
+#include <vector>
+
+namespace llvm {
+namespace locstats {
+
+namespace {
+
+const uint32_t Stmt = CompactLineTable::IsStmt;
+const uint32_t PrologueEnd = CompactLineTable::PrologueEnd;
+const uint32_t EpilogueBegin = CompactLineTable::EpilogueBegin;
+const uint64_t UndefSection = object::SectionedAddress::UndefSection;
+
+struct TestRow {
+  uint64_t Address;
+  uint32_t Line;
+  uint16_t File;
+  uint32_t Flags;
+};
+
+/// Address, file, line and flags, as passed to forEachRow().
+using RowTuple = std::tuple<uint64_t, uint32_t, uint32_t, uint32_t>;
+
+/// Return an empty DWARF v4 line table, without files.
+DWARFDebugLine::LineTable createLineTable() {
+  DWARFDebugLine::LineTable LineTable;
+  LineTable.Prologue.FormParams.Version = 4;
+  return LineTable;
+}
+
+/// Append a sequence of \p Rows, ended at \p HighPC, to \p LineTable.
+void appendSequence(DWARFDebugLine::LineTable &LineTable,
+                    uint64_t SectionIndex, ArrayRef<TestRow> Rows,
+                    uint64_t HighPC) {
+  DWARFDebugLine::Sequence Seq;
+  Seq.LowPC = Rows.front().Address;
+  Seq.HighPC = HighPC;
+  Seq.SectionIndex = SectionIndex;
+  Seq.FirstRowIndex = LineTable.Rows.size();
+  Seq.Empty = false;
+  for (const TestRow &TR : Rows) {
+    DWARFDebugLine::Row Row;
+    Row.Address = {TR.Address, SectionIndex};
+    Row.Line = TR.Line;
+    Row.File = TR.File;
+    Row.IsStmt = (TR.Flags & Stmt) != 0;
+    Row.PrologueEnd = (TR.Flags & PrologueEnd) != 0;
+    Row.EpilogueBegin = (TR.Flags & EpilogueBegin) != 0;
+    LineTable.appendRow(Row);
+  }
+  DWARFDebugLine::Row End;
+  End.Address = {HighPC, SectionIndex};
+  End.EndSequence = true;
+  LineTable.appendRow(End);
+  Seq.LastRowIndex = LineTable.Rows.size();
+  LineTable.appendSequence(Seq);
+}
+
+std::vector<RowTuple> getRows(const CompactLineTable &Table, uint64_t LowPC,
+                              uint64_t HighPC, uint64_t SectionIndex) {
+  std::vector<RowTuple> Result;
+  Table.forEachRow(LowPC, HighPC, SectionIndex,
+                   [&](uint64_t Address, uint32_t File, uint32_t Line,
+                       uint32_t Flags) {
+                     Result.emplace_back(Address, File, Line, Flags);
+                   });
+  return Result;
+}
+
+class CompactLineTableTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    // Out of order, as the sequences of a line table may be.
+    appendSequence(LineTable, 2, {{0x1000, 30, 1, Stmt}}, 0x1008);
+    appendSequence(LineTable, 1, {{0x2000, 20, 2, Stmt | EpilogueBegin}},
+                   0x2010);
+    appendSequence(LineTable, 1,
+                   {{0x1000, 10, 1, Stmt},
+                    {0x1010, 11, 1, Stmt | PrologueEnd},
+                    {0x1020, 12, 1, 0}},
+                   0x1030);
+    Table = llvm::make_unique<CompactLineTable>(LineTable, nullptr);
+  }
+
+  DWARFDebugLine::LineTable LineTable = createLineTable();
+  std::unique_ptr<CompactLineTable> Table;
+};
+
+TEST_F(CompactLineTableTest, Size) {
+  // The end of sequence rows are not kept.
+  EXPECT_EQ(5u, Table->size());
+}
+
+TEST_F(CompactLineTableTest, WholeSection) {
+  std::vector<RowTuple> Expected = {
+      RowTuple{0x1000, 1, 10, Stmt},
+      RowTuple{0x1010, 1, 11, Stmt | PrologueEnd},
+      RowTuple{0x1020, 1, 12, 0},
+      RowTuple{0x2000, 2, 20, Stmt | EpilogueBegin}};
+  EXPECT_EQ(Expected, getRows(*Table, 0, UINT64_MAX, 1));
+}
+
+TEST_F(CompactLineTableTest, CoveringRow) {
+  // The row starting before the range covers its start.
+  std::vector<RowTuple> Expected = {
+      RowTuple{0x1014, 1, 11, Stmt | PrologueEnd},
+      RowTuple{0x1020, 1, 12, 0}};
+  EXPECT_EQ(Expected, getRows(*Table, 0x1014, 0x1024, 1));
+
+  Expected = {RowTuple{0x1000, 1, 10, Stmt}};
+  EXPECT_EQ(Expected, getRows(*Table, 0x1000, 0x1010, 1));
+  Expected = {RowTuple{0x102f, 1, 12, 0}};
+  EXPECT_EQ(Expected, getRows(*Table, 0x102f, 0x1030, 1));
+}
+
+TEST_F(CompactLineTableTest, OutsideSequences) {
+  EXPECT_TRUE(getRows(*Table, 0, 0x1000, 1).empty());
+  EXPECT_TRUE(getRows(*Table, 0x1030, 0x2000, 1).empty());
+  EXPECT_TRUE(getRows(*Table, 0x2010, UINT64_MAX, 1).empty());
+  EXPECT_TRUE(getRows(*Table, 0x1000, 0x1100, 3).empty());
+  // An empty range has no rows.
+  EXPECT_TRUE(getRows(*Table, 0x1010, 0x1010, 1).empty());
+  EXPECT_TRUE(getRows(*Table, 0x1020, 0x1010, 1).empty());
+}
+
+TEST_F(CompactLineTableTest, Sections) {
+  std::vector<RowTuple> Expected = {RowTuple{0x1004, 1, 30, Stmt}};
+  EXPECT_EQ(Expected, getRows(*Table, 0x1004, 0x1010, 2));
+
+  // Without a section index, each section is searched in turn.
+  Expected = {RowTuple{0x1004, 1, 10, Stmt}, RowTuple{0x1004, 1, 30, Stmt}};
+  EXPECT_EQ(Expected, getRows(*Table, 0x1004, 0x1010, UndefSection));
+}
+
+TEST_F(CompactLineTableTest, FileNames) {
+  // The prologue has no files.
+  EXPECT_EQ("<unknown>", Table->getFileName(0));
+  EXPECT_EQ("<unknown>", Table->getFileName(1));
+  EXPECT_EQ("<unknown>", Table->getFileName(CompactLineTable::FileMask));
+}
+
+TEST(CompactLineTable, BinarySearch) {
+  DWARFDebugLine::LineTable LineTable = createLineTable();
+  std::vector<TestRow> Rows;
+  for (uint32_t I = 0; I < 1000; ++I)
+    Rows.push_back({0x10000 + 4 * I, I + 1, 1, Stmt});
+  appendSequence(LineTable, 1, Rows, 0x10000 + 4 * 1000);
+  CompactLineTable Table(LineTable, nullptr);
+
+  for (uint32_t I = 0; I < 1000; I += 37) {
+    uint64_t Address = 0x10000 + 4 * I;
+    std::vector<RowTuple> Expected = {RowTuple{Address + 2, 1, I + 1, Stmt}};
+    EXPECT_EQ(Expected, getRows(Table, Address + 2, Address + 3, 1));
+    if (I + 1 < 1000) {
+      Expected.push_back(RowTuple{Address + 4, 1, I + 2, Stmt});
+      EXPECT_EQ(Expected, getRows(Table, Address + 2, Address + 5, 1));
+    }
+  }
+}
+
+TEST(CompactLineTable, WideSequence) {
+  // The sequence is split where the address deltas no longer fit in 32 bits.
+  DWARFDebugLine::LineTable LineTable = createLineTable();
+  appendSequence(LineTable, 1,
+                 {{0x10, 1, 1, Stmt},
+                  {0x100000000, 2, 1, Stmt},
+                  {0x100000020, 3, 1, Stmt}},
+                 0x100000040);
+  CompactLineTable Table(LineTable, nullptr);
+  EXPECT_EQ(3u, Table.size());
+
+  std::vector<RowTuple> Expected = {RowTuple{0xfffffff0, 1, 1, Stmt},
+                                    RowTuple{0x100000000, 1, 2, Stmt},
+                                    RowTuple{0x100000020, 1, 3, Stmt}};
+  EXPECT_EQ(Expected, getRows(Table, 0xfffffff0, 0x100000030, 1));
+}
+
+} // namespace
+} // namespace locstats
+} // namespace llvm
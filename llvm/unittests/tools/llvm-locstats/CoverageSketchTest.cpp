@@ -0,0 +1,129 @@
+//===-- CoverageSketchTest.cpp ----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "CoverageSketch.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+#include <cmath>
+
+namespace llvm {
+namespace locstats {
+
+namespace {
+
+TEST(CoverageSketchTest, Boundaries) {
+  CoverageSketch Sketch;
+  // An empty scope has a NaN coverage, which counts as 0%.
+  Sketch.add(-1);
+  Sketch.add(0);
+  Sketch.add(0.05);
+  Sketch.add(NAN);
+  Sketch.add(99.99);
+  Sketch.add(100);
+  Sketch.add(150, 2);
+
+  EXPECT_EQ(8u, Sketch.getTotal());
+  EXPECT_EQ(4u, Sketch.getWeightForPercent(0));
+  EXPECT_EQ(1u, Sketch.getWeightForPercent(99));
+  EXPECT_EQ(3u, Sketch.getWeightForPercent(100));
+  EXPECT_EQ(0, Sketch.getQuantile(0.5));
+  EXPECT_DOUBLE_EQ(99.9, Sketch.getQuantile(0.625));
+  EXPECT_EQ(100, Sketch.getQuantile(0.75));
+  EXPECT_EQ(100, Sketch.getQuantile(1));
+}
+
+TEST(CoverageSketchTest, WeightForPercent) {
+  CoverageSketch Sketch;
+  Sketch.add(12);
+  Sketch.add(12.35);
+  Sketch.add(12.95);
+  Sketch.add(13);
+
+  EXPECT_EQ(0u, Sketch.getWeightForPercent(11));
+  EXPECT_EQ(3u, Sketch.getWeightForPercent(12));
+  EXPECT_EQ(1u, Sketch.getWeightForPercent(13));
+}
+
+TEST(CoverageSketchTest, Empty) {
+  CoverageSketch Sketch;
+  EXPECT_EQ(0u, Sketch.getTotal());
+  EXPECT_EQ(0, Sketch.getQuantile(0.5));
+  EXPECT_EQ(0u, Sketch.getWeightForPercent(0));
+  EXPECT_EQ(0u, Sketch.getWeightForPercent(100));
+}
+
+TEST(CoverageSketchTest, MergeAndQuantiles) {
+  CoverageSketch A;
+  A.add(10, 3);
+  A.add(50);
+  CoverageSketch B;
+  B.add(90, 4);
+
+  A.merge(B);
+  EXPECT_EQ(8u, A.getTotal());
+  EXPECT_EQ(3u, A.getWeightForPercent(10));
+  EXPECT_EQ(1u, A.getWeightForPercent(50));
+  EXPECT_EQ(4u, A.getWeightForPercent(90));
+
+  EXPECT_EQ(10, A.getQuantile(0));
+  EXPECT_EQ(10, A.getQuantile(0.25));
+  EXPECT_EQ(10, A.getQuantile(0.375));
+  EXPECT_EQ(50, A.getQuantile(0.5));
+  EXPECT_EQ(90, A.getQuantile(0.51));
+  EXPECT_EQ(90, A.getQuantile(1));
+  // The other sketch is unchanged.
+  EXPECT_EQ(4u, B.getTotal());
+  EXPECT_EQ(90, B.getQuantile(0));
+}
+
+TEST(CoverageSketchTest, JSONRoundTrip) {
+  CoverageSketch Sketch;
+  Sketch.add(0, 2);
+  Sketch.add(33.35);
+  Sketch.add(66.65, 5);
+  Sketch.add(100, 7);
+
+  std::string Serialized;
+  raw_string_ostream OS(Serialized);
+  OS << Sketch.toJSON();
+  OS.flush();
+  EXPECT_EQ("[[0,2],[333,1],[666,5],[1000,7]]", Serialized);
+
+  Expected<json::Value> Parsed = json::parse(Serialized);
+  ASSERT_THAT_EXPECTED(Parsed, Succeeded());
+  CoverageSketch Read;
+  ASSERT_TRUE(Read.fromJSON(*Parsed));
+  EXPECT_EQ(Sketch.getTotal(), Read.getTotal());
+  for (unsigned Percent = 0; Percent <= 100; ++Percent)
+    EXPECT_EQ(Sketch.getWeightForPercent(Percent),
+              Read.getWeightForPercent(Percent));
+  EXPECT_EQ(Sketch.getQuantile(0.5), Read.getQuantile(0.5));
+
+  // Reading adds to the bins, like merging.
+  ASSERT_TRUE(Read.fromJSON(*Parsed));
+  EXPECT_EQ(2 * Sketch.getTotal(), Read.getTotal());
+  EXPECT_EQ(14u, Read.getWeightForPercent(100));
+}
+
+TEST(CoverageSketchTest, MalformedJSON) {
+  CoverageSketch Sketch;
+  EXPECT_FALSE(Sketch.fromJSON(json::Object{}));
+  EXPECT_FALSE(Sketch.fromJSON(json::Array{1}));
+  EXPECT_FALSE(Sketch.fromJSON(json::Array{json::Array{1}}));
+  EXPECT_FALSE(Sketch.fromJSON(json::Array{json::Array{-1, 1}}));
+  EXPECT_FALSE(Sketch.fromJSON(json::Array{json::Array{1001, 1}}));
+  EXPECT_FALSE(Sketch.fromJSON(json::Array{json::Array{1, -1}}));
+  EXPECT_FALSE(Sketch.fromJSON(json::Array{json::Array{1, "1"}}));
+  EXPECT_TRUE(Sketch.fromJSON(json::Array{}));
+  EXPECT_EQ(0u, Sketch.getTotal());
+}
+
+} // namespace
+} // namespace locstats
+} // namespace llvm
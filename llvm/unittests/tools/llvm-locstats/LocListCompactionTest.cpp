@@ -0,0 +1,197 @@
+//===-- LocListCompactionTest.cpp -------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LocListCompaction.h"
+#include "llvm/Support/JSON.h"
+#include "gtest/gtest.h"
+
+namespace llvm {
+namespace locstats {
+
+namespace {
+
+// DW_OP_reg0 and DW_OP_reg1.
+const StringRef Reg0("\x50");
+const StringRef Reg1("\x51");
+
+RawLocEntry entry(uint64_t Begin, uint64_t End, StringRef Expr) {
+  return {Begin, End, Expr, false};
+}
+
+/// A base address selection entry, setting the base to \p BaseAddr.
+RawLocEntry baseAddress(uint64_t BaseAddr) {
+  return {UINT64_MAX, BaseAddr, StringRef(), true};
+}
+
+LocCompactionStats summarizeList(ArrayRef<RawLocEntry> Entries,
+                                 uint64_t BaseAddr, uint8_t AddressSize) {
+  LocListCompaction Compaction;
+  Compaction.addList(0, Entries, BaseAddr, AddressSize);
+  return Compaction.summarize();
+}
+
+TEST(LocListCompactionTest, EndOfList) {
+  // Only the end of list entry: two addresses in .debug_loc, and a single
+  // DW_LLE_end_of_list byte in .debug_loclists.
+  LocCompactionStats Stats = summarizeList({}, 0, 8);
+  EXPECT_EQ(1u, Stats.Lists);
+  EXPECT_EQ(0u, Stats.Entries);
+  EXPECT_EQ(16u, Stats.Bytes);
+  EXPECT_EQ(1u, Stats.V5Bytes);
+
+  Stats = summarizeList({}, 0, 4);
+  EXPECT_EQ(8u, Stats.Bytes);
+  EXPECT_EQ(1u, Stats.V5Bytes);
+
+  // Each entry takes two addresses, the expression length and the
+  // expression.
+  Stats = summarizeList({entry(0x10, 0x20, Reg0)}, 0, 4);
+  EXPECT_EQ(1u, Stats.Entries);
+  EXPECT_EQ(8u + 11u, Stats.Bytes);
+  EXPECT_EQ(1u + 5u, Stats.V5Bytes);
+}
+
+TEST(LocListCompactionTest, Mergeable) {
+  LocCompactionStats Stats = summarizeList({entry(0x10, 0x20, Reg0),
+                                            entry(0x20, 0x30, Reg0),
+                                            entry(0x30, 0x40, Reg1),
+                                            entry(0x40, 0x50, Reg1),
+                                            entry(0x58, 0x60, Reg1)},
+                                           0x1000, 8);
+  EXPECT_EQ(5u, Stats.Entries);
+  EXPECT_EQ(16u + 5 * 19u, Stats.Bytes);
+  // The second entry extends the first, and the fourth the third. The third
+  // has another expression, and the last one leaves a gap.
+  EXPECT_EQ(2u, Stats.MergeableEntries);
+  EXPECT_EQ(2 * 19u, Stats.MergeableBytes);
+  EXPECT_EQ(0u, Stats.EmptyEntries);
+  EXPECT_EQ(0u, Stats.DuplicateLists);
+}
+
+TEST(LocListCompactionTest, Empty) {
+  LocCompactionStats Stats = summarizeList({entry(0x10, 0x10, Reg0),
+                                            entry(0x30, 0x20, Reg0),
+                                            entry(0x10, 0x20, Reg0),
+                                            entry(0x28, 0x28, Reg0),
+                                            entry(0x20, 0x30, Reg0)},
+                                           0x1000, 8);
+  EXPECT_EQ(5u, Stats.Entries);
+  EXPECT_EQ(16u + 5 * 19u, Stats.Bytes);
+  // Begin >= End.
+  EXPECT_EQ(3u, Stats.EmptyEntries);
+  EXPECT_EQ(3 * 19u, Stats.EmptyBytes);
+  // The empty entries are dropped, so the last entry extends the third.
+  EXPECT_EQ(1u, Stats.MergeableEntries);
+  EXPECT_EQ(19u, Stats.MergeableBytes);
+  // An empty entry has an offset pair with an empty range.
+  EXPECT_EQ(1u + 5 * 5u, Stats.V5Bytes);
+}
+
+TEST(LocListCompactionTest, Duplicates) {
+  LocListCompaction Compaction;
+  // The same entries, once their addresses are made absolute.
+  Compaction.addList(0x00, {entry(0x10, 0x20, Reg0)}, 0x1000, 8);
+  Compaction.addList(0x40, {entry(0x08, 0x18, Reg0)}, 0x1008, 8);
+  Compaction.addList(0x80, {baseAddress(0x1000), entry(0x10, 0x20, Reg0)}, 0,
+                     8);
+  // Another expression.
+  Compaction.addList(0xc0, {entry(0x10, 0x20, Reg1)}, 0x1000, 8);
+  // Other addresses.
+  Compaction.addList(0x100, {entry(0x10, 0x20, Reg0)}, 0x2000, 8);
+
+  LocCompactionStats Stats = Compaction.summarize();
+  EXPECT_EQ(5u, Stats.Lists);
+  // All the copies but the smallest one could share it.
+  EXPECT_EQ(2u, Stats.DuplicateLists);
+  EXPECT_EQ(35u + 51u, Stats.DuplicateBytes);
+}
+
+TEST(LocListCompactionTest, BaseAddressRuns) {
+  // The first run is relative to the unit base, the second one to the
+  // selected base.
+  LocCompactionStats Stats = summarizeList({entry(0x10, 0x20, Reg0),
+                                            baseAddress(0x400000),
+                                            entry(0x00, 0x10, Reg0),
+                                            entry(0x10, 0x20, Reg0)},
+                                           0, 8);
+  // The base address selection entry is not counted as an entry.
+  EXPECT_EQ(3u, Stats.Entries);
+  EXPECT_EQ(16u + 16u + 3 * 19u, Stats.Bytes);
+  EXPECT_EQ(1u, Stats.MergeableEntries);
+  // The first run is kept as offset pairs. The selected base needs a
+  // DW_LLE_base_address entry, even if the offsets are small.
+  EXPECT_EQ(1u + 5u + (9u + 2 * 5u), Stats.V5Bytes);
+
+  // A base address selection ending the list still takes a
+  // DW_LLE_base_address entry.
+  Stats = summarizeList({entry(0x10, 0x20, Reg0), baseAddress(0x400000)}, 0,
+                        8);
+  EXPECT_EQ(1u, Stats.Entries);
+  EXPECT_EQ(16u + 19u + 16u, Stats.Bytes);
+  EXPECT_EQ(1u + 5u + 9u, Stats.V5Bytes);
+}
+
+TEST(LocListCompactionTest, V5RunSize) {
+  // Small offsets from the unit base are cheaper as they are.
+  LocCompactionStats Stats = summarizeList(
+      {entry(0x10, 0x20, Reg0), entry(0x20, 0x30, Reg1)}, 0x1000, 8);
+  EXPECT_EQ(1u + 2 * 5u, Stats.V5Bytes);
+
+  // Offsets of 4 bytes of ULEB128 each are cheaper from a new base.
+  Stats = summarizeList(
+      {entry(0x400000, 0x400010, Reg0), entry(0x400010, 0x400020, Reg1)}, 0,
+      8);
+  EXPECT_EQ(1u + (9u + 2 * 5u), Stats.V5Bytes);
+  Stats = summarizeList(
+      {entry(0x400000, 0x400010, Reg0), entry(0x400010, 0x400020, Reg1)}, 0,
+      4);
+  EXPECT_EQ(1u + (5u + 2 * 5u), Stats.V5Bytes);
+
+  // A single entry does not pay for the base address entry.
+  Stats = summarizeList({entry(0x400000, 0x400010, Reg0)}, 0, 8);
+  EXPECT_EQ(1u + 11u, Stats.V5Bytes);
+}
+
+TEST(LocListCompactionTest, MergeUnits) {
+  LocListCompaction A;
+  A.addList(0x00, {entry(0x10, 0x20, Reg0)}, 0x1000, 8);
+  A.addList(0x40, {entry(0x10, 0x20, Reg1)}, 0x1000, 8);
+  EXPECT_TRUE(A.contains(0x40));
+  EXPECT_FALSE(A.contains(0x80));
+
+  // The parts of a split unit may refer to the same lists.
+  LocListCompaction B;
+  B.addList(0x40, {entry(0x10, 0x20, Reg1)}, 0x1000, 8);
+  B.addList(0x80, {entry(0x08, 0x18, Reg0)}, 0x1008, 8);
+  A.merge(B);
+  EXPECT_TRUE(A.contains(0x80));
+
+  LocCompactionStats Stats = A.summarize();
+  EXPECT_EQ(3u, Stats.Lists);
+  EXPECT_EQ(3u, Stats.Entries);
+  EXPECT_EQ(1u, Stats.DuplicateLists);
+  EXPECT_EQ(35u, Stats.DuplicateBytes);
+}
+
+TEST(LocListCompactionTest, StatsJSON) {
+  LocCompactionStats Stats = summarizeList(
+      {entry(0x10, 0x20, Reg0), entry(0x20, 0x20, Reg0)}, 0x1000, 8);
+  LocCompactionStats Read;
+  ASSERT_TRUE(Read.fromJSON(Stats.toJSON()));
+  ASSERT_TRUE(Read.fromJSON(Stats.toJSON()));
+  EXPECT_EQ(2 * Stats.Lists, Read.Lists);
+  EXPECT_EQ(2 * Stats.Entries, Read.Entries);
+  EXPECT_EQ(2 * Stats.Bytes, Read.Bytes);
+  EXPECT_EQ(2 * Stats.EmptyBytes, Read.EmptyBytes);
+  EXPECT_EQ(2 * Stats.V5Bytes, Read.V5Bytes);
+  EXPECT_FALSE(Read.fromJSON(json::Array{}));
+}
+
+} // namespace
+} // namespace locstats
+} // namespace llvm
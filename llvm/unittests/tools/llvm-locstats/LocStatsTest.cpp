@@ -0,0 +1,152 @@
+//===-- LocStatsTest.cpp ----------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LocStats.h"
+#include "llvm/BinaryFormat/ELF.h"
+#include "llvm/DebugInfo/DWARF/DWARFContext.h"
+#include "llvm/Object/ELFTypes.h"
+#include "llvm/Object/ObjectFile.h"
+#include "llvm/ObjectYAML/DWARFEmitter.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <cstring>
+
+namespace llvm {
+namespace locstats {
+
+namespace {
+
+using testing::HasSubstr;
+
+/// An ELF relocatable object without sections. The tool only reads the
+/// sections of linked binaries, and the DWARF is given to the context.
+struct EmptyObject {
+  EmptyObject() {
+    std::memset(&Header, 0, sizeof(Header));
+    std::memcpy(Header.e_ident, ELF::ElfMagic, std::strlen(ELF::ElfMagic));
+    Header.e_ident[ELF::EI_CLASS] = ELF::ELFCLASS64;
+    Header.e_ident[ELF::EI_DATA] = ELF::ELFDATA2LSB;
+    Header.e_ident[ELF::EI_VERSION] = ELF::EV_CURRENT;
+    Header.e_type = ELF::ET_REL;
+    Header.e_machine = ELF::EM_X86_64;
+    Header.e_version = ELF::EV_CURRENT;
+    Header.e_ehsize = sizeof(Header);
+  }
+
+  Expected<std::unique_ptr<object::ObjectFile>> create() const {
+    return object::ObjectFile::createObjectFile(MemoryBufferRef(
+        StringRef((const char *)&Header, sizeof(Header)), "nested"));
+  }
+
+  object::ELF64LE::Ehdr Header;
+};
+
+TEST(LocStatsTest, DeeplyNestedScopes) {
+  // A subprogram holding a chain of lexical blocks, one per level, with a
+  // variable without location in the innermost one, then a variable with a
+  // location in the subprogram itself. A declaration holds the same chain,
+  // which is skipped. The traversal used to recurse once per level, which
+  // the default stack did not allow this deep.
+  const uint32_t MaxDepth = 50000;
+  std::string yamldata = R"(
+    debug_abbrev:
+      - Code:            0x00000001
+        Tag:             DW_TAG_compile_unit
+        Children:        DW_CHILDREN_yes
+        Attributes:
+      - Code:            0x00000002
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_low_pc
+            Form:            DW_FORM_addr
+          - Attribute:       DW_AT_high_pc
+            Form:            DW_FORM_data4
+      - Code:            0x00000003
+        Tag:             DW_TAG_subprogram
+        Children:        DW_CHILDREN_yes
+        Attributes:
+          - Attribute:       DW_AT_declaration
+            Form:            DW_FORM_flag_present
+      - Code:            0x00000004
+        Tag:             DW_TAG_lexical_block
+        Children:        DW_CHILDREN_yes
+        Attributes:
+      - Code:            0x00000005
+        Tag:             DW_TAG_variable
+        Children:        DW_CHILDREN_no
+        Attributes:
+      - Code:            0x00000006
+        Tag:             DW_TAG_variable
+        Children:        DW_CHILDREN_no
+        Attributes:
+          - Attribute:       DW_AT_location
+            Form:            DW_FORM_exprloc
+    debug_info:
+      - Length:
+          TotalLength:     0
+        Version:         4
+        AbbrOffset:      0
+        AddrSize:        8
+        Entries:
+          - AbbrCode:        0x00000001
+            Values:
+)";
+  auto AddChain = [&] {
+    for (uint32_t Depth = 2; Depth < MaxDepth; ++Depth)
+      yamldata += "          - AbbrCode:        0x00000004\n"
+                  "            Values:\n";
+    yamldata += "          - AbbrCode:        0x00000005\n"
+                "            Values:\n";
+    for (uint32_t Depth = 2; Depth < MaxDepth; ++Depth)
+      yamldata += "          - AbbrCode:        0x00000000\n"
+                  "            Values:\n";
+  };
+  yamldata += "          - AbbrCode:        0x00000002\n"
+              "            Values:\n"
+              "              - Value:           0x0000000000001000\n"
+              "              - Value:           0x0000000000000010\n";
+  AddChain();
+  // DW_OP_reg0, over the whole subprogram.
+  yamldata += "          - AbbrCode:        0x00000006\n"
+              "            Values:\n"
+              "              - BlockData:       [ 0x50 ]\n"
+              "          - AbbrCode:        0x00000000\n"
+              "            Values:\n";
+  yamldata += "          - AbbrCode:        0x00000003\n"
+              "            Values:\n"
+              "              - Value:           0x0000000000000001\n";
+  AddChain();
+  yamldata += "          - AbbrCode:        0x00000000\n"
+              "            Values:\n"
+              "          - AbbrCode:        0x00000000\n"
+              "            Values:\n";
+
+  auto ErrOrSections = DWARFYAML::EmitDebugSections(yamldata, true);
+  ASSERT_TRUE((bool)ErrOrSections);
+  std::unique_ptr<DWARFContext> DwarfContext =
+      DWARFContext::create(*ErrOrSections, 8);
+  ASSERT_EQ(DwarfContext->getUnitAtIndex(0)->getNumDIEs(), 4 * MaxDepth + 1);
+
+  EmptyObject Empty;
+  auto Obj = Empty.create();
+  ASSERT_TRUE((bool)Obj);
+  std::string Report;
+  raw_string_ostream OS(Report);
+  collectLocstats(**Obj, *DwarfContext, "nested", OS);
+  OS.flush();
+
+  EXPECT_THAT(Report,
+              HasSubstr("-the number of debug variables processed: 2\n"));
+  EXPECT_THAT(Report, HasSubstr("-the average coverage per var: ~ 50%\n"));
+}
+
+} // namespace
+} // namespace locstats
+} // namespace llvm